@@ -0,0 +1,57 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "types.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Times BMSSP on a random graph large enough to miss in cache, for a range
+// of prefetch distances. Usage: bench_prefetch [n] [avg_degree] [repeats]
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 1000000;
+    int degree = argc > 2 ? atoi(argv[2]) : 4;
+    int repeats = argc > 3 ? atoi(argv[3]) : 3;
+
+    mt19937 rng(42);
+    uniform_int_distribution<int> node(0, n - 1);
+    uniform_real_distribution<double> weight(1.0, 100.0);
+    vector<vector<Edge>> adj(n);
+    for (long long i = 0; i < (long long)n * degree; ++i)
+        adj[node(rng)].push_back({node(rng), weight(rng)});
+    CsrGraph csr = build_csr(n, adj);
+    vector<vector<Edge>>().swap(adj);
+
+    cout << "Graph: " << n << " nodes, " << csr.view().edge_count()
+         << " edges (CSR)" << endl;
+    vector<double> reference;
+    for (int distance : {0, 1, 2, 4, 8, 16, 32}) {
+        SsspOptions opts;
+        opts.prefetch_distance = distance;
+        double best = 0;
+        for (int r = 0; r < repeats; ++r) {
+            auto start_time = chrono::high_resolution_clock::now();
+            vector<double> dist = solve_sssp(csr.view(), 0, opts);
+            auto end_time = chrono::high_resolution_clock::now();
+            double ms = chrono::duration_cast<chrono::microseconds>(
+                            end_time - start_time)
+                            .count() /
+                        1000.0;
+            best = r == 0 ? ms : min(best, ms);
+            if (reference.empty())
+                reference = dist;
+            else if (dist != reference) {
+                cerr << "Distances differ at prefetch distance " << distance
+                     << endl;
+                return 1;
+            }
+        }
+        cout << "Prefetch distance " << distance << ": " << best << " ms"
+             << endl;
+    }
+    return 0;
+}
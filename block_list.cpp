@@ -20,48 +20,58 @@ void BlockList::erase_element(list<Block>::iterator block_it, int elem_idx) {
     auto& elems = block_it->elements;
     int last = (int)elems.size() - 1;
     if (elem_idx != last) {
-        int swapped_u = elems[last].u;
+        vertex_t swapped_u = elems[last].u;
         locator[swapped_u].elem_idx = elem_idx;
         swap(elems[elem_idx], elems[last]);
     }
     elems.pop_back();
 }
 
-void BlockList::insert(int u, double d) {
+// Removes u, dropping its block when it becomes empty.
+void BlockList::erase_node(vertex_t u) {
     auto loc_it = locator.find(u);
-    if (loc_it != locator.end()) {
-        if (d >= loc_it->second.dist)
-            return;
-
-        auto& info = loc_it->second;
-        erase_element(info.block_it, info.elem_idx);
-
-        if (info.block_it->elements.empty()) {
-            if (info.type == LIST_D1) {
-                D1_Index.erase({info.block_it->upper_bound, info.block_it->id});
-                D1.erase(info.block_it);
-            } else {
-                D0.erase(info.block_it);
-            }
+    if (loc_it == locator.end())
+        return;
+    auto& info = loc_it->second;
+    erase_element(info.block_it, info.elem_idx);
+    if (info.block_it->elements.empty()) {
+        if (info.type == LIST_D1) {
+            D1_Index.erase({info.block_it->upper_bound, info.block_it->id});
+            D1.erase(info.block_it);
+        } else {
+            D0.erase(info.block_it);
         }
-        locator.erase(loc_it);
     }
+    locator.erase(loc_it);
+}
 
-    if (D1.empty()) {
-        Block b;
-        b.upper_bound = B_global;
-        b.id = next_block_id++;
-        D1.push_back(b);
-        D1_Index.insert({{b.upper_bound, b.id}, D1.begin()});
+void BlockList::insert(vertex_t u, double d) {
+    auto loc_it = locator.find(u);
+    if (loc_it != locator.end()) {
+        if (d >= loc_it->second.dist)
+            return;
+        erase_node(u);
     }
 
     auto idx_it = D1_Index.lower_bound({d, INT_MIN});
     list<Block>::iterator target_block;
 
     if (idx_it == D1_Index.end()) {
-        target_block = --D1.end();
+        // Every upper bound is below d (the last block, bounded by B_global,
+        // was emptied and removed). Appending to the last block would break
+        // the ordering of D1, so a new last block is opened.
+        Block b;
+        b.upper_bound = B_global;
+        b.id = next_block_id++;
+        target_block = D1.insert(D1.end(), b);
+        D1_Index.insert({{b.upper_bound, b.id}, target_block});
     } else {
+        // Blocks that share an upper bound (ties at a split) need not sit in
+        // id order along D1; take the first of them in list order.
         target_block = idx_it->second;
+        while (target_block != D1.begin() &&
+               prev(target_block)->upper_bound >= d)
+            --target_block;
     }
 
     target_block->elements.push_back({u, d});
@@ -142,8 +152,9 @@ void BlockList::partition_into_blocks_d0(vector<Element>& arr, int start,
     partition_into_blocks_d0(arr, mid, end, blocks);
 }
 
-void BlockList::batch_prepend(const vector<pair<int, double>>& elements) {
-    unordered_map<int, double> best;
+void BlockList::batch_prepend(
+    const vector<pair<vertex_t, double>>& elements) {
+    unordered_map<vertex_t, double> best;
     best.reserve(elements.size());
     for (const auto& p : elements) {
         auto it = best.find(p.first);
@@ -160,18 +171,7 @@ void BlockList::batch_prepend(const vector<pair<int, double>>& elements) {
         if (loc_it != locator.end()) {
             if (el.d >= loc_it->second.dist)
                 continue;
-            auto& info = loc_it->second;
-            erase_element(info.block_it, info.elem_idx);
-            if (info.block_it->elements.empty()) {
-                if (info.type == LIST_D1) {
-                    D1_Index.erase(
-                        {info.block_it->upper_bound, info.block_it->id});
-                    D1.erase(info.block_it);
-                } else {
-                    D0.erase(info.block_it);
-                }
-            }
-            locator.erase(loc_it);
+            erase_node(el.u);
         }
         to_add.push_back(el);
     }
@@ -209,11 +209,39 @@ void BlockList::batch_prepend(const vector<pair<int, double>>& elements) {
     D0.splice(D0.begin(), new_blocks);
 }
 
+// Moves every element with distance d into out. Blocks are ordered, so the
+// scan stops at the first D0 block above d and after the first D1 block
+// whose upper bound exceeds d.
+void BlockList::take_equal(double d, vector<vertex_t>& out) {
+    vector<vertex_t> ids;
+    for (auto& block : D0) {
+        double lo = std::numeric_limits<double>::infinity();
+        for (auto& el : block.elements) {
+            lo = min(lo, el.d);
+            if (el.d == d)
+                ids.push_back(el.u);
+        }
+        if (lo > d)
+            break;
+    }
+    for (auto& block : D1) {
+        for (auto& el : block.elements)
+            if (el.d == d)
+                ids.push_back(el.u);
+        if (block.upper_bound > d)
+            break;
+    }
+    for (vertex_t u : ids) {
+        erase_node(u);
+        out.push_back(u);
+    }
+}
+
 BlockList::PullResult BlockList::pull() {
-    vector<int> frontier_ids;
+    vector<vertex_t> frontier_ids;
     double next_bound = std::numeric_limits<double>::infinity();
 
-    vector<pair<double, int>> candidates;
+    vector<pair<double, vertex_t>> candidates;
 
     int collected_d0 = 0;
     for (auto bit = D0.begin(); bit != D0.end(); ++bit) {
@@ -239,48 +267,42 @@ BlockList::PullResult BlockList::pull() {
         return {{}, B_global};
 
     int K = (int)candidates.size();
+    double top = -std::numeric_limits<double>::infinity();
     if (K <= M) {
-        for (const auto& p : candidates)
+        for (const auto& p : candidates) {
             frontier_ids.push_back(p.second);
+            top = max(top, p.first);
+        }
     } else {
+        // Pairs compare by (distance, node id), so equal distances are
+        // selected by id and the outcome never depends on insertion order.
         nth_element(candidates.begin(), candidates.begin() + M,
-                    candidates.end(),
-                    [](const pair<double, int>& a, const pair<double, int>& b) {
-                        return a.first < b.first;
-                    });
+                    candidates.end());
         double dM = candidates[M].first;
 
         for (int i = 0; i < M; ++i) {
-            if (candidates[i].first < dM)
+            if (candidates[i].first < dM) {
                 frontier_ids.push_back(candidates[i].second);
+                top = max(top, candidates[i].first);
+            }
         }
 
         if (frontier_ids.empty()) {
             for (int i = 0; i < M; ++i) {
                 frontier_ids.push_back(candidates[i].second);
             }
+            top = dM;
         }
     }
 
     // Erase selected elements from the structure
-    for (int u : frontier_ids) {
-        auto loc_it = locator.find(u);
-        if (loc_it != locator.end()) {
-            auto& info = loc_it->second;
-            erase_element(info.block_it, info.elem_idx);
-
-            if (info.block_it->elements.empty()) {
-                if (info.type == LIST_D1) {
-                    D1_Index.erase(
-                        {info.block_it->upper_bound, info.block_it->id});
-                    D1.erase(info.block_it);
-                } else {
-                    D0.erase(info.block_it);
-                }
-            }
-            locator.erase(loc_it);
-        }
-    }
+    for (vertex_t u : frontier_ids)
+        erase_node(u);
+
+    // The bound must be strictly above every pulled distance. Elements tied
+    // with the largest one (possibly in blocks not scanned above) come along,
+    // even if the frontier grows past M.
+    take_equal(top, frontier_ids);
 
     // Compute the actual minimum remaining value in D0 ∪ D1
     if (locator.empty()) {
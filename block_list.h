@@ -16,7 +16,7 @@ struct BlockList {
     double B_global;
 
     struct Element {
-        int u;
+        vertex_t u;
         double d;
     };
 
@@ -43,16 +43,16 @@ struct BlockList {
 
     int next_block_id = 0;
 
-    unordered_map<int, LocatorInfo> locator;
+    unordered_map<vertex_t, LocatorInfo> locator;
 
     BlockList(int m_val, double b_val);
 
-    void insert(int u, double d);
+    void insert(vertex_t u, double d);
 
-    void batch_prepend(const vector<pair<int, double>>& elements);
+    void batch_prepend(const vector<pair<vertex_t, double>>& elements);
 
     struct PullResult {
-        vector<int> frontier;
+        vector<vertex_t> frontier;
         double bound;
     };
 
@@ -65,6 +65,8 @@ struct BlockList {
     void partition_into_blocks_d0(vector<Element>& arr, int start, int end,
                                    list<Block>& blocks);
     void erase_element(list<Block>::iterator block_it, int elem_idx);
+    void erase_node(vertex_t u);
+    void take_equal(double d, vector<vertex_t>& out);
 };
 
 #endif // BLOCK_LIST_H
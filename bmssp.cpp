@@ -1,50 +1,378 @@
 #include "bmssp.h"
 #include "block_list.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "huge_pages.h"
+#include "landmarks.h"
+#include "parallel.h"
 #include "trace.h"
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
 #include <queue>
 #include <unordered_set>
 #include <vector>
 
 using namespace std;
 
+// Distance labels and per-node work arrays are indexed by random node ids,
+// so they follow the huge page policy to keep dTLB misses down.
+using DistArray = HugeVector<double>;
+
+// A relaxation proposed in deterministic mode. Candidates are ordered by
+// (to, d, from), so the winner for each target is the lowest distance with
+// ties going to the lowest predecessor id.
+struct Candidate {
+    vertex_t to;
+    vertex_t from;
+    double d;
+
+    bool operator<(const Candidate& other) const {
+        if (to != other.to)
+            return to < other.to;
+        if (d != other.d)
+            return d < other.d;
+        return from < other.from;
+    }
+};
+
 struct WorkArrays {
-    vector<int> bp_map;    // BFS parent, -1 = unset
-    vector<int> tree_size; // tree size accumulator, 0 = unset
-    vector<int> bp_dirty;  // indices written to bp_map
+    HugeVector<vertex_t> bp_map;    // BFS parent, -1 = unset
+    HugeVector<vertex_t> tree_size; // tree size accumulator, 0 = unset
+    vector<vertex_t> bp_dirty;      // indices written to bp_map
+
+    // Nodes settled by the running base case carry its stamp, so no
+    // per-call set or clearing pass is needed.
+    HugeVector<unsigned> settled;
+    unsigned settle_stamp = 0;
+
+    // Goal-directed pruning for point-to-point queries (see SsspOptions)
+    vertex_t target = -1;
+    const Landmarks* landmarks = nullptr;
+
+    // Edges of lookahead in the relaxation kernel, 0 = no prefetching
+    int prefetch_distance = 0;
+
+    // Predecessor output (see SsspOptions::parents), null when not wanted
+    vertex_t* parent = nullptr;
+
+    // Skip tie relaxations of already expanded nodes (SsspOptions::strict)
+    bool strict = false;
 
-    WorkArrays(int n) : bp_map(n, -1), tree_size(n, 0) {}
+    // Deterministic parallel mode (see SsspOptions::threads): per-worker
+    // candidate buffers, reused across rounds.
+    int threads = 0;
+    vector<vector<Candidate>> buffers;
+
+    // Cooperative stop (see SsspOptions::cancel) and settled-node visitor
+    // (SsspOptions::on_settled). `proven` marks the nodes whose labels are
+    // final and is only kept when one of them is in use.
+    const CancelToken* cancel = nullptr;
+    chrono::steady_clock::time_point deadline =
+        chrono::steady_clock::time_point::max();
+    bool stoppable = false;
+    unsigned polls = 0;
+    SolveStatus stop = SOLVE_COMPLETE;
+    const SettledVisitor* visitor = nullptr;
+    vector<char> proven;
+
+    // When set, collects every node given a label (see SearchState).
+    vector<vertex_t>* reached = nullptr;
+
+    WorkArrays(vertex_t n) : bp_map(n, -1), tree_size(n, 0), settled(n, 0) {}
+
+    bool stopped() const { return stop != SOLVE_COMPLETE; }
+
+    // Polls the token on every call and the clock on every 32nd.
+    bool should_stop() {
+        if (!stoppable || stopped())
+            return stopped();
+        if (cancel && cancel->is_cancelled())
+            stop = SOLVE_CANCELLED;
+        else if ((++polls & 31) == 0 &&
+                 chrono::steady_clock::now() >= deadline)
+            stop = SOLVE_DEADLINE;
+        return stopped();
+    }
+
+    // Records that v has its final label d and reports it to the visitor
+    // the first time.
+    void set_proven(vertex_t v, double d) {
+        if (proven.empty() || proven[v])
+            return;
+        proven[v] = 1;
+        if (visitor && !stopped() && !(*visitor)(v, d))
+            stop = SOLVE_STOPPED;
+    }
+
+    // Starts a new base case: no node is settled in it yet.
+    void next_settle_stamp() {
+        if (++settle_stamp == 0) {
+            fill(settled.begin(), settled.end(), 0);
+            settle_stamp = 1;
+        }
+    }
+
+    bool is_settled(vertex_t v) const { return settled[v] == settle_stamp; }
 
     void reset_bp() {
-        for (int i : bp_dirty)
-            bp_map[i] = -1;
+        for (vertex_t v : bp_dirty)
+            bp_map[v] = -1;
         bp_dirty.clear();
     }
+
+    // A relaxation reaching v at cost d is useless for the target when
+    // d + h(v) cannot beat the best target distance found so far.
+    bool prune(vertex_t v, double d, const DistArray& min_costs) const {
+        return landmarks &&
+               d + landmarks->lower_bound(v, target) >= min_costs[target];
+    }
+
+    void set_parent(vertex_t v, vertex_t u) const {
+        if (parent)
+            parent[v] = u;
+    }
+
+    // Writes label d for v, reached from u. The predecessor only moves on a
+    // strict improvement: equal-cost relaxations (zero weights) could
+    // otherwise re-link the source or close a cycle.
+    void set_label(DistArray& min_costs, vertex_t v, double d,
+                   vertex_t u) const {
+        if (d < min_costs[v])
+            set_parent(v, u);
+        if (reached && min_costs[v] == numeric_limits<double>::infinity())
+            reached->push_back(v);
+        min_costs[v] = d;
+    }
 };
 
-static pair<vector<int>, vector<int>>
-find_pivots(double bound, const vector<int>& frontier, int k,
-            const vector<vector<Edge>>& adj, vector<double>& min_costs,
-            WorkArrays& work) {
-    vector<int> all_layers = frontier;
-    vector<int> last_layer = frontier;
+// Batches with fewer edges are relaxed on the calling thread; the result
+// does not depend on this choice.
+static const size_t PARALLEL_MIN_EDGES = 1 << 14;
+
+// bp_map value of a frontier node in find_pivots (a root of the forest).
+static const vertex_t ROOT = -2;
+
+static inline void prefetch_write(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 1, 3);
+#else
+    (void)p;
+#endif
+}
+
+static inline void prefetch_read(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 0, 3);
+#else
+    (void)p;
+#endif
+}
+
+// Starts loading the edges of v ahead of its relaxation.
+static inline void prefetch_row(const vector<vector<Edge>>& adj, vertex_t v) {
+    prefetch_read(adj[v].data());
+}
+
+static inline void prefetch_row(const CsrView& adj, vertex_t v) {
+    edge_t begin = adj.offsets[v];
+    prefetch_read(adj.targets + begin);
+    prefetch_read(adj.weights + begin);
+}
+
+static inline void prefetch_row(const CompressedView& adj, vertex_t v) {
+    prefetch_read(adj.data + adj.row_offset(v));
+}
+
+// Relaxation kernel shared by all phases: calls relax(e) for every edge of
+// u. With a prefetch distance D, the label of the target D edges ahead is
+// requested while the current edge is relaxed, so the misses on
+// min_costs[e.to] overlap instead of stalling one after another.
+template <class Graph, class Relax>
+static inline void relax_row(const Graph& adj, vertex_t u,
+                             const DistArray& min_costs, int distance,
+                             Relax relax) {
+    const auto& row = adj[u];
+    size_t deg = row.size();
+    if (distance <= 0) {
+        for (size_t i = 0; i < deg; ++i)
+            relax(row[i]);
+        return;
+    }
+    size_t ahead = min(deg, (size_t)distance);
+    for (size_t i = 0; i < ahead; ++i)
+        prefetch_write(&min_costs[row[i].to]);
+    for (size_t i = 0; i < deg; ++i) {
+        if (i + ahead < deg)
+            prefetch_write(&min_costs[row[i + ahead].to]);
+        relax(row[i]);
+    }
+}
+
+// Compressed rows are not randomly accessible, so the edges are relaxed as
+// the iterator decodes them. With prefetching, a second iterator runs D
+// edges ahead and decodes each edge once more to find the target to load.
+template <class Relax>
+static inline void relax_row(const CompressedView& adj, vertex_t u,
+                             const DistArray& min_costs, int distance,
+                             Relax relax) {
+    CompressedRow row = adj[u];
+    auto end = row.end();
+    if (distance <= 0) {
+        for (auto it = row.begin(); it != end; ++it)
+            relax(*it);
+        return;
+    }
+    auto ahead = row.begin();
+    for (int i = 0; i < distance && ahead != end; ++i, ++ahead)
+        prefetch_write(&min_costs[(*ahead).to]);
+    for (auto it = row.begin(); it != end; ++it) {
+        if (ahead != end) {
+            prefetch_write(&min_costs[(*ahead).to]);
+            ++ahead;
+        }
+        relax(*it);
+    }
+}
+
+// Deterministic relaxation of all edges leaving `nodes`: workers propose
+// improvements against the current labels without writing them, and the
+// proposals are reduced in (to, d, from) order to one winner per target.
+// The winners (sorted by target) are independent of the thread count and of
+// how the nodes were split, so applying them in order is reproducible.
+template <class Graph>
+static void relax_batch(const Graph& adj, const vector<vertex_t>& nodes,
+                        const DistArray& min_costs, WorkArrays& work,
+                        vector<Candidate>& winners) {
+    size_t edges = 0;
+    for (vertex_t u : nodes) {
+        edges += adj[u].size();
+        if (edges >= PARALLEL_MIN_EDGES)
+            break;
+    }
+    int threads = edges >= PARALLEL_MIN_EDGES ? max(1, work.threads) : 1;
+    if ((int)work.buffers.size() < threads)
+        work.buffers.resize(threads);
+
+    parallel_for((int)nodes.size(), threads, [&](int w, int i) {
+        vertex_t u = nodes[i];
+        double du = min_costs[u];
+        vector<Candidate>& out = work.buffers[w];
+        relax_row(adj, u, min_costs, work.prefetch_distance,
+                  [&](const Edge& e) {
+            double d = du + e.weight;
+            if (d <= min_costs[e.to] && !work.prune(e.to, d, min_costs))
+                out.push_back({e.to, u, d});
+        });
+    }, 64);
+
+    winners.clear();
+    auto same_target = [](const Candidate& a, const Candidate& b) {
+        return a.to == b.to;
+    };
+    if (threads == 1) {
+        winners.swap(work.buffers[0]);
+        sort(winners.begin(), winners.end());
+        winners.erase(unique(winners.begin(), winners.end(), same_target),
+                      winners.end());
+        return;
+    }
+
+    // Each worker sorts its own proposals; a heap merge of the sorted runs
+    // keeps the first (smallest) proposal per target.
+    parallel_for(threads, threads, [&](int, int w) {
+        sort(work.buffers[w].begin(), work.buffers[w].end());
+    });
+    typedef pair<Candidate, int> Head; // next proposal, buffer
+    vector<Head> heads;
+    vector<size_t> next(threads, 1);
+    for (int w = 0; w < threads; ++w)
+        if (!work.buffers[w].empty())
+            heads.push_back({work.buffers[w][0], w});
+    auto later = [](const Head& a, const Head& b) { return b.first < a.first; };
+    make_heap(heads.begin(), heads.end(), later);
+    while (!heads.empty()) {
+        pop_heap(heads.begin(), heads.end(), later);
+        Head& h = heads.back();
+        if (winners.empty() || !same_target(winners.back(), h.first))
+            winners.push_back(h.first);
+        const vector<Candidate>& run = work.buffers[h.second];
+        if (next[h.second] < run.size()) {
+            h.first = run[next[h.second]++];
+            push_heap(heads.begin(), heads.end(), later);
+        } else {
+            heads.pop_back();
+        }
+    }
+    for (int w = 0; w < threads; ++w)
+        work.buffers[w].clear();
+}
+
+// The search functions are templates over the graph type: adjacency lists
+// (vector<vector<Edge>>) or a CSR view. Both yield Edge values per row.
+template <class Graph>
+static pair<vector<vertex_t>, vector<vertex_t>>
+find_pivots(double bound, const vector<vertex_t>& frontier, int k,
+            const Graph& adj, DistArray& min_costs, WorkArrays& work) {
+    vector<vertex_t> all_layers = frontier;
+    vector<vertex_t> last_layer = frontier;
+
+    // Frontier nodes start as roots of the forest. A node takes u as its
+    // tree parent on a strict improvement (a frontier node that was not yet
+    // complete leaves its root role then), or on an equal distance if it
+    // has no parent yet. A parent's label never exceeds its child's, so a
+    // strict improvement cannot close a cycle; re-linking on equal
+    // distances (zero weights) could. In strict mode a tie on a node that is
+    // already in the forest is dropped: its edges are relaxed at that label
+    // anyway.
+    for (vertex_t s : frontier) {
+        work.bp_map[s] = ROOT;
+        work.bp_dirty.push_back(s);
+    }
+    auto link = [&](vertex_t v, vertex_t u, bool improved) {
+        if (!improved && work.bp_map[v] != -1)
+            return;
+        if (work.bp_map[v] == -1)
+            work.bp_dirty.push_back(v);
+        work.bp_map[v] = u;
+    };
 
     for (int i = 0; i < k; ++i) {
-        vector<int> new_layer;
-        for (int u : last_layer) {
-            for (auto& e : adj[u]) {
-                double d = min_costs[u] + e.weight;
-                if (d <= min_costs[e.to]) {
-                    min_costs[e.to] = d;
+        vector<vertex_t> new_layer;
+        if (work.threads > 0) {
+            vector<Candidate> winners;
+            relax_batch(adj, last_layer, min_costs, work, winners);
+            for (const auto& c : winners) {
+                bool improved = c.d < min_costs[c.to];
+                if (!improved && work.strict && work.bp_map[c.to] != -1)
+                    continue;
+                work.set_label(min_costs, c.to, c.d, c.from);
+                if (c.d < bound) {
+                    new_layer.push_back(c.to);
+                    link(c.to, c.from, improved);
+                }
+            }
+        }
+        for (size_t j = 0; work.threads == 0 && j < last_layer.size(); ++j) {
+            vertex_t u = last_layer[j];
+            if (work.prefetch_distance > 0 && j + 1 < last_layer.size())
+                prefetch_row(adj, last_layer[j + 1]);
+            double du = min_costs[u];
+            relax_row(adj, u, min_costs, work.prefetch_distance,
+                      [&](const Edge& e) {
+                double d = du + e.weight;
+                if (d <= min_costs[e.to] && !work.prune(e.to, d, min_costs)) {
+                    bool improved = d < min_costs[e.to];
+                    if (!improved && work.strict && work.bp_map[e.to] != -1)
+                        return;
+                    work.set_label(min_costs, e.to, d, u);
                     if (d < bound) {
                         new_layer.push_back(e.to);
-                        work.bp_map[e.to] = u;
-                        work.bp_dirty.push_back(e.to);
+                        link(e.to, u, improved);
                     }
                 }
-            }
+            });
         }
         all_layers.insert(all_layers.end(), new_layer.begin(), new_layer.end());
         last_layer = new_layer;
@@ -55,11 +383,11 @@ find_pivots(double bound, const vector<int>& frontier, int k,
     }
 
     // Trace from leaves to roots, accumulate tree sizes
-    unordered_set<int> roots;
-    for (int leaf : last_layer) {
-        int cur = leaf;
+    unordered_set<vertex_t> roots;
+    for (vertex_t leaf : last_layer) {
+        vertex_t cur = leaf;
         int count = 0;
-        while (work.bp_map[cur] != -1) {
+        while (work.bp_map[cur] >= 0) {
             cur = work.bp_map[cur];
             count++;
         }
@@ -68,8 +396,8 @@ find_pivots(double bound, const vector<int>& frontier, int k,
     }
 
     // Collect pivots (roots with large enough trees)
-    vector<int> pivots;
-    for (int r : roots) {
+    vector<vertex_t> pivots;
+    for (vertex_t r : roots) {
         if (work.tree_size[r] >= k)
             pivots.push_back(r);
         work.tree_size[r] = 0; // reset inline
@@ -78,8 +406,8 @@ find_pivots(double bound, const vector<int>& frontier, int k,
     work.reset_bp();
 
     // Build pairs with distances for trace output
-    std::vector<std::pair<int, double>> all_layers_with_dist;
-    for (int id : all_layers) {
+    std::vector<std::pair<vertex_t, double>> all_layers_with_dist;
+    for (vertex_t id : all_layers) {
         all_layers_with_dist.push_back({id, min_costs[id]});
     }
     TRACE("FIND_PIVOTS",
@@ -88,49 +416,66 @@ find_pivots(double bound, const vector<int>& frontier, int k,
     return {pivots, all_layers};
 }
 
-static pair<double, vector<int>>
-base_bmssp(double B, int node_id, int base_limit,
-           const vector<vector<Edge>>& adj, vector<double>& min_costs) {
-    TRACE("BASE_CASE", TF("node", node_id) TF("B", B));
+// Dijkstra from the (complete) frontier nodes below B. Once base_limit
+// nodes are settled, only nodes tied with the last settled distance are
+// taken, so the returned bound (the next distance in the queue) is strictly
+// above every returned node even when many distances are equal.
+template <class Graph>
+static pair<double, vector<vertex_t>>
+base_bmssp(double B, const vector<vertex_t>& frontier, int base_limit,
+           const Graph& adj, DistArray& min_costs, WorkArrays& work) {
+    TRACE("BASE_CASE", TF("nodes", vec_json(frontier)) TF("B", B));
     priority_queue<State, vector<State>, greater<State>> pq;
-    pq.push({node_id, min_costs[node_id]});
-    vector<int> u_init;
-    double max_cost = min_costs[node_id];
+    for (vertex_t x : frontier)
+        pq.push({x, min_costs[x]});
+    vector<vertex_t> u_init;
+    work.next_settle_stamp();
+    double max_cost = -numeric_limits<double>::infinity();
 
-    while (!pq.empty() && (int)u_init.size() < base_limit) {
+    while (!pq.empty() && !work.should_stop()) {
         State top = pq.top();
-        pq.pop();
-        // Lazy deletion: skip stale entries (replaces visited set)
-        if (top.cost > min_costs[top.node_id])
+        // Lazy deletion: skip stale entries and repeated equal-cost pushes
+        if (top.cost > min_costs[top.node_id] || work.is_settled(top.node_id)) {
+            pq.pop();
             continue;
+        }
+        if ((int)u_init.size() >= base_limit && top.cost > max_cost)
+            break;
+        pq.pop();
         TRACE("BASE_PQ_POP", TF("node", top.node_id) TF("cost", top.cost));
+        work.settled[top.node_id] = work.settle_stamp;
         u_init.push_back(top.node_id);
-        max_cost = max(max_cost, top.cost);
+        work.set_proven(top.node_id, top.cost);
+        max_cost = top.cost;
+        // The current queue head is the likely next node to settle.
+        if (work.prefetch_distance > 0 && !pq.empty())
+            prefetch_row(adj, pq.top().node_id);
 
-        for (auto& e : adj[top.node_id]) {
+        relax_row(adj, top.node_id, min_costs, work.prefetch_distance,
+                  [&](const Edge& e) {
             double d = top.cost + e.weight;
-            if (d <= min_costs[e.to] && d < B) {
-                min_costs[e.to] = d;
+            if (d <= min_costs[e.to] && d < B &&
+                !work.prune(e.to, d, min_costs)) {
+                if (work.strict && d == min_costs[e.to] &&
+                    work.is_settled(e.to))
+                    return;
+                work.set_label(min_costs, e.to, d, top.node_id);
                 TRACE("BASE_RELAX",
                       TF("from", top.node_id) TF("to", e.to) TF("cost", d));
                 pq.push({e.to, d});
             }
-        }
+        });
     }
-    if ((int)u_init.size() < base_limit)
+    if (pq.empty())
         return {B, u_init};
-    vector<int> filtered_u;
-    for (int id : u_init)
-        if (min_costs[id] < max_cost)
-            filtered_u.push_back(id);
-    return {max_cost, filtered_u};
-}
-
-static pair<double, vector<int>>
-bmssp_bounded(int l, double B, const vector<int>& frontier, int k, int t,
-              int n, int base_limit, const vector<vector<Edge>>& adj,
-              vector<double>& min_costs, WorkArrays& work,
-              bool is_top = false) {
+    return {pq.top().cost, u_init};
+}
+
+template <class Graph>
+static pair<double, vector<vertex_t>>
+bmssp_bounded(int l, double B, const vector<vertex_t>& frontier, int k, int t,
+              vertex_t n, int base_limit, const Graph& adj, DistArray& min_costs,
+              WorkArrays& work, bool is_top = false) {
     TRACE("RECURSION_ENTER",
           TF("l", l) TF("B", B) TF("frontier", vec_json(frontier)));
 
@@ -140,7 +485,7 @@ bmssp_bounded(int l, double B, const vector<int>& frontier, int k, int t,
     // levels. Avoids find_pivots + BlockList overhead when the parent loop
     // will continue the expansion.
     if (l == 0 || (!is_top && frontier.size() <= 1))
-        return base_bmssp(B, frontier[0], base_limit, adj, min_costs);
+        return base_bmssp(B, frontier, base_limit, adj, min_costs, work);
 
     auto pivot_data = find_pivots(B, frontier, k, adj, min_costs, work);
 
@@ -150,8 +495,8 @@ bmssp_bounded(int l, double B, const vector<int>& frontier, int k, int t,
     BlockList block_list(M, B);
     double min_ub = B;
 
-    std::vector<std::pair<int, double>> pivot_inserts;
-    for (int p : pivot_data.first) {
+    std::vector<std::pair<vertex_t, double>> pivot_inserts;
+    for (vertex_t p : pivot_data.first) {
         block_list.insert(p, min_costs[p]);
         min_ub = min(min_ub, min_costs[p]);
         pivot_inserts.push_back({p, min_costs[p]});
@@ -159,50 +504,137 @@ bmssp_bounded(int l, double B, const vector<int>& frontier, int k, int t,
     if (!pivot_inserts.empty())
         TRACE("BL_INSERT", TF("elements", pairs_json(pivot_inserts)));
 
-    vector<int> u_set;
+    vector<vertex_t> u_set;
     int shift_u = t * l;
     size_t max_u = (shift_u >= 60) ? (size_t)k << 60
                                    : (size_t)k << shift_u;
 
-    while (u_set.size() < max_u && !block_list.is_empty()) {
+    // U may list a node more than once, so at the top level the size limit
+    // (k * 2^(lt) > n) can be reached early; the top level always drains
+    // the list.
+    while ((is_top || u_set.size() < max_u) && !block_list.is_empty() &&
+           !work.should_stop()) {
         auto pulled = block_list.pull();
         TRACE("BL_PULL",
               TF("nodes", vec_json(pulled.frontier)) TF("bound", pulled.bound));
         auto res = bmssp_bounded(l - 1, pulled.bound, pulled.frontier, k, t, n,
                                  base_limit, adj, min_costs, work);
+        // An interrupted call proves nothing about its bound.
+        if (work.stopped())
+            return {min_ub, u_set};
         min_ub = res.first;
 
-        vector<pair<int, double>> to_prepend;
-        vector<pair<int, double>> d1_inserts;
-        for (int u : res.second) {
+        vector<pair<vertex_t, double>> to_prepend;
+        vector<pair<vertex_t, double>> d1_inserts;
+        if (work.threads > 0) {
+            u_set.insert(u_set.end(), res.second.begin(), res.second.end());
+            vector<Candidate> winners;
+            relax_batch(adj, res.second, min_costs, work, winners);
+            for (const auto& c : winners) {
+                work.set_label(min_costs, c.to, c.d, c.from);
+                if (c.d >= pulled.bound && c.d < B) {
+                    block_list.insert(c.to, c.d);
+                    d1_inserts.push_back({c.to, c.d});
+                } else if (c.d >= res.first && c.d < pulled.bound)
+                    to_prepend.push_back({c.to, c.d});
+            }
+        }
+        for (size_t j = 0; work.threads == 0 && j < res.second.size(); ++j) {
+            vertex_t u = res.second[j];
             u_set.push_back(u);
-            for (auto& e : adj[u]) {
-                double d = min_costs[u] + e.weight;
-                if (d <= min_costs[e.to]) {
-                    min_costs[e.to] = d;
+            if (work.prefetch_distance > 0 && j + 1 < res.second.size())
+                prefetch_row(adj, res.second[j + 1]);
+            double du = min_costs[u];
+            relax_row(adj, u, min_costs, work.prefetch_distance,
+                      [&](const Edge& e) {
+                double d = du + e.weight;
+                if (d <= min_costs[e.to] && !work.prune(e.to, d, min_costs)) {
+                    work.set_label(min_costs, e.to, d, u);
                     if (d >= pulled.bound && d < B) {
                         block_list.insert(e.to, d);
                         d1_inserts.push_back({e.to, d});
                     } else if (d >= res.first && d < pulled.bound)
                         to_prepend.push_back({e.to, d});
                 }
-            }
+            });
         }
+        // Pulled nodes the recursion did not complete go back in front.
+        for (vertex_t x : pulled.frontier)
+            if (min_costs[x] >= res.first && min_costs[x] < pulled.bound)
+                to_prepend.push_back({x, min_costs[x]});
         if (!d1_inserts.empty())
             TRACE("BL_INSERT", TF("elements", pairs_json(d1_inserts)));
         block_list.batch_prepend(to_prepend);
         TRACE("BL_PREPEND", TF("elements", pairs_json(to_prepend)));
     }
 
-    for (int id : pivot_data.second)
-        if (min_costs[id] < min_ub)
+    if (work.stopped())
+        return {min_ub, u_set};
+    for (vertex_t id : pivot_data.second)
+        if (min_costs[id] < min_ub) {
             u_set.push_back(id);
+            work.set_proven(id, min_costs[id]);
+        }
     TRACE("RECURSION_EXIT",
           TF("l", l) TF("min_ub", min_ub) TF("u_set", vec_json(u_set)));
     return {min_ub, u_set};
 }
 
-vector<double> solve_sssp(int n, const vector<vector<Edge>>& adj, int start) {
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start) {
+    return solve_sssp(n, adj, start, numeric_limits<double>::infinity());
+}
+
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start, double bound) {
+    SsspOptions opts;
+    opts.bound = bound;
+    return solve_sssp(n, adj, start, opts);
+}
+
+// Labels and work arrays of a search. A tracked state lists every labeled
+// node in `reached`, so it can run further searches on the same graph and
+// reset only what the previous one touched instead of all n entries.
+struct SearchState {
+    DistArray min_costs;
+    WorkArrays work;
+    vector<vertex_t> reached;
+    bool tracked;
+
+    SearchState(vertex_t n, bool track)
+        : min_costs(n, numeric_limits<double>::infinity()), work(n),
+          tracked(track) {
+        if (tracked)
+            work.reached = &reached;
+    }
+
+    // Calls f(v) for every node that may hold a label.
+    template <class F> void for_reached(vertex_t n, F f) const {
+        if (tracked)
+            for (vertex_t v : reached)
+                f(v);
+        else
+            for (vertex_t v = 0; v < n; ++v)
+                f(v);
+    }
+
+    void reset() {
+        for (vertex_t v : reached) {
+            min_costs[v] = numeric_limits<double>::infinity();
+            if (!work.proven.empty())
+                work.proven[v] = 0;
+        }
+        reached.clear();
+    }
+};
+
+// Runs the search on `state` and, when `result` is set, copies the
+// distances into it.
+template <class Graph>
+static SolveStatus search(SearchState& state, vertex_t n, const Graph& adj,
+                          vertex_t start, const SsspOptions& opts,
+                          vector<double>* result) {
+    double bound = opts.bound;
     double logn = log2(n);
     int k = max(2, (int)pow(logn, 1.0 / 3.0));
     int t = max(1, (int)pow(logn, 2.0 / 3.0));
@@ -210,16 +642,346 @@ vector<double> solve_sssp(int n, const vector<vector<Edge>>& adj, int start) {
     TRACE("SOLVE_START",
           TF("n", n) TF("k", k) TF("t", t) TF("l", l) TF("source", start));
 
-    vector<double> min_costs(n, numeric_limits<double>::infinity());
+    state.reset();
+    DistArray& min_costs = state.min_costs;
     min_costs[start] = 0;
+    if (state.tracked)
+        state.reached.push_back(start);
 
     // Opt 2: Pre-allocate flat arrays for find_pivots
-    WorkArrays work(n);
+    WorkArrays& work = state.work;
+    work.target = -1;
+    work.landmarks = nullptr;
+    if (opts.target >= 0 && opts.landmarks && !opts.landmarks->empty()) {
+        work.target = opts.target;
+        work.landmarks = opts.landmarks;
+    }
+
+    work.prefetch_distance = opts.prefetch_distance;
+    work.threads = max(0, opts.threads);
+    work.strict = opts.strict;
+    work.parent = nullptr;
+    if (opts.parents) {
+        opts.parents->assign(n, -1);
+        work.parent = opts.parents->data();
+    }
+    work.cancel = opts.cancel;
+    work.deadline = opts.deadline;
+    work.stoppable =
+        opts.cancel || opts.deadline != chrono::steady_clock::time_point::max();
+    work.polls = 0;
+    work.stop = SOLVE_COMPLETE;
+    work.visitor = opts.on_settled ? &opts.on_settled : nullptr;
+    if (work.stoppable || work.visitor) {
+        if (work.proven.empty())
+            work.proven.assign(n, 0);
+        work.set_proven(start, 0);
+    }
 
     // Opt 5: Enlarged base case limit
     int base_limit = max(k + 1, 1 << t);
 
-    bmssp_bounded(l, numeric_limits<double>::infinity(), {start}, k, t, n,
-                  base_limit, adj, min_costs, work, /*is_top=*/true);
-    return min_costs;
+    bmssp_bounded(l, bound, {start}, k, t, n, base_limit, adj, min_costs, work,
+                  /*is_top=*/true);
+
+    SolveStatus status = work.stop;
+    if (opts.status)
+        *opts.status = status;
+    if (work.stopped()) {
+        // The predecessor of a proven node was exact when it relaxed the
+        // node's final label, so whole tree paths are proven.
+        state.for_reached(n, [&](vertex_t v) {
+            for (vertex_t u = v; work.parent && work.proven[u] &&
+                            work.parent[u] >= 0 &&
+                            !work.proven[work.parent[u]];
+                 u = work.parent[u])
+                work.proven[work.parent[u]] = 1;
+        });
+        state.for_reached(n, [&](vertex_t v) {
+            if (!work.proven[v]) {
+                min_costs[v] = numeric_limits<double>::infinity();
+                work.set_parent(v, -1);
+            }
+        });
+    }
+
+    // Relaxations may leave tentative values at or above the bound; those
+    // nodes are outside the requested ball.
+    if (bound != numeric_limits<double>::infinity()) {
+        state.for_reached(n, [&](vertex_t v) {
+            if (min_costs[v] >= bound) {
+                min_costs[v] = numeric_limits<double>::infinity();
+                work.set_parent(v, -1);
+            }
+        });
+    }
+
+    // The top level does not list the pivots it left at or above its last
+    // pull bound; their labels are final all the same.
+    if (work.visitor && !work.stopped())
+        state.for_reached(n, [&](vertex_t v) {
+            if (min_costs[v] != numeric_limits<double>::infinity())
+                work.set_proven(v, min_costs[v]);
+        });
+
+    if (result)
+        result->assign(min_costs.begin(), min_costs.end());
+    return status;
+}
+
+// Tracked states for k-nearest and bidirectional queries, which need one
+// and two of them. They stay with the calling thread and are reused by its
+// later queries on graphs with the same node count, so only the first
+// query pays for allocating and clearing n entries.
+static SearchState& tracked_state(vertex_t n, int slot) {
+    thread_local unique_ptr<SearchState> states[2];
+    unique_ptr<SearchState>& state = states[slot];
+    if (!state || (vertex_t)state->min_costs.size() != n)
+        state.reset(new SearchState(n, /*track=*/true));
+    return *state;
+}
+
+// A single search on fresh arrays.
+template <class Graph>
+static SolveStatus run(vertex_t n, const Graph& adj, vertex_t start,
+                       const SsspOptions& opts, vector<double>* result) {
+    SearchState state(n, /*track=*/false);
+    return search(state, n, adj, start, opts, result);
+}
+
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start, const SsspOptions& opts) {
+    vector<double> result;
+    run(n, adj, start, opts, &result);
+    return result;
+}
+
+vector<double> solve_sssp(const CsrView& graph, vertex_t start,
+                          const SsspOptions& opts) {
+    vector<double> result;
+    run(graph.n, graph, start, opts, &result);
+    return result;
+}
+
+vector<double> solve_sssp(const CompressedView& graph, vertex_t start,
+                          const SsspOptions& opts) {
+    vector<double> result;
+    run(graph.n, graph, start, opts, &result);
+    return result;
+}
+
+SolveStatus visit_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                       vertex_t start,
+                       const SettledVisitor& visitor, SsspOptions opts) {
+    opts.on_settled = visitor;
+    return run(n, adj, start, opts, nullptr);
+}
+
+SolveStatus visit_sssp(const CsrView& graph, vertex_t start,
+                       const SettledVisitor& visitor, SsspOptions opts) {
+    opts.on_settled = visitor;
+    return run(graph.n, graph, start, opts, nullptr);
+}
+
+SolveStatus visit_sssp(const CompressedView& graph, vertex_t start,
+                       const SettledVisitor& visitor, SsspOptions opts) {
+    opts.on_settled = visitor;
+    return run(graph.n, graph, start, opts, nullptr);
+}
+
+template <class Graph>
+static vector<Neighbor> nearest(vertex_t n, const Graph& adj, vertex_t source,
+                                int k,
+                                const uint64_t* category, SsspOptions opts,
+                                int* rounds) {
+    const double INF = numeric_limits<double>::infinity();
+    double limit = opts.bound;
+    SolveStatus* status_out = opts.status;
+    SolveStatus status = SOLVE_COMPLETE;
+    opts.status = &status;
+    opts.parents = nullptr;
+
+    // Start from the cheapest edge leaving the source.
+    double B = INF;
+    for (const auto& e : adj[source])
+        B = min(B, e.weight);
+    if (!(B > 0) || B == INF)
+        B = 1.0;
+
+    // Every round reuses the arrays and resets only the nodes the previous
+    // one labeled, so a round costs the work inside its ball.
+    SearchState& state = tracked_state(n, 0);
+    vector<Neighbor> matches;
+    bool last_round = false;
+    int round = 0;
+    while (k > 0) {
+        round++;
+        B = min(B, limit);
+        matches.clear();
+        opts.bound = B;
+        opts.on_settled = [&](vertex_t v, double d) {
+            if (!category || (category[v >> 6] >> (v & 63)) & 1)
+                matches.push_back({v, d});
+            return last_round || (int)matches.size() < k;
+        };
+        search(state, n, adj, source, opts, nullptr);
+        if (status == SOLVE_STOPPED) {
+            // k matches are proven, so the k-th nearest is no farther than
+            // the k-th of them. One complete round just past it finds all
+            // the candidates without exploring the rest of the ball.
+            nth_element(matches.begin(), matches.begin() + (k - 1),
+                        matches.end(),
+                        [](const Neighbor& a, const Neighbor& b) {
+                            return a.dist < b.dist;
+                        });
+            B = nextafter(matches[k - 1].dist, INF);
+            last_round = true;
+            continue;
+        }
+        if (status != SOLVE_COMPLETE || (int)matches.size() >= k ||
+            B >= limit)
+            break;
+
+        // The ball is exactly the labeled nodes below B, so the cheapest
+        // edge leaving it gives the next distance; none means it is
+        // complete.
+        double next = INF;
+        for (vertex_t u : state.reached) {
+            double du = state.min_costs[u];
+            if (du == INF)
+                continue;
+            for (const auto& e : adj[u])
+                if (state.min_costs[e.to] == INF)
+                    next = min(next, du + e.weight);
+        }
+        if (next == INF)
+            break;
+        B = max(2 * B, nextafter(next, INF));
+    }
+
+    sort(matches.begin(), matches.end(),
+         [](const Neighbor& a, const Neighbor& b) {
+             return a.dist != b.dist ? a.dist < b.dist : a.node < b.node;
+         });
+    if ((int)matches.size() > k)
+        matches.resize(k);
+    if (status_out)
+        *status_out = status;
+    if (rounds)
+        *rounds = round;
+    return matches;
+}
+
+vector<Neighbor> nearest_k(vertex_t n, const vector<vector<Edge>>& adj,
+                           vertex_t source, int k, const uint64_t* category, SsspOptions opts,
+                           int* rounds) {
+    return nearest(n, adj, source, k, category, opts, rounds);
+}
+
+vector<Neighbor> nearest_k(const CsrView& graph, vertex_t source, int k,
+                           const uint64_t* category, SsspOptions opts,
+                           int* rounds) {
+    return nearest(graph.n, graph, source, k, category, opts, rounds);
+}
+
+// Best s-t path length through an edge (or node) joining the forward ball
+// f and the backward ball b. Also reports whether each ball still has
+// edges leaving it, i.e. whether its search could grow further. Only the
+// nodes each search labeled are visited.
+static double meeting_distance(const vector<vector<Edge>>& adj,
+                               const vector<vector<Edge>>& radj,
+                               const SearchState& f, const SearchState& b,
+                               bool& grow_f, bool& grow_b) {
+    const double INF = numeric_limits<double>::infinity();
+    const DistArray& df = f.min_costs;
+    const DistArray& db = b.min_costs;
+    double best = INF;
+    grow_f = grow_b = false;
+    for (vertex_t u : f.reached) {
+        if (df[u] == INF)
+            continue;
+        if (db[u] != INF)
+            best = min(best, df[u] + db[u]);
+        for (const auto& e : adj[u]) {
+            if (db[e.to] != INF)
+                best = min(best, df[u] + e.weight + db[e.to]);
+            else if (df[e.to] == INF)
+                grow_f = true;
+        }
+    }
+    for (vertex_t u : b.reached) {
+        if (db[u] == INF)
+            continue;
+        for (const auto& e : radj[u])
+            grow_b = grow_b || db[e.to] == INF;
+        if (grow_b)
+            break;
+    }
+    return best;
+}
+
+double bidirectional_bmssp(vertex_t n, const vector<vector<Edge>>& adj,
+                           const vector<vector<Edge>>& radj, vertex_t source,
+                           vertex_t target, int* rounds) {
+    const double INF = numeric_limits<double>::infinity();
+    if (source == target) {
+        if (rounds)
+            *rounds = 0;
+        return 0.0;
+    }
+
+    // Start from the cheapest edge leaving source or entering target.
+    double B = INF;
+    for (const auto& e : adj[source])
+        B = min(B, e.weight);
+    for (const auto& e : radj[target])
+        B = min(B, e.weight);
+    if (!(B > 0) || B == INF)
+        B = 1.0;
+
+    // Both balls reuse tracked arrays, so a round costs the work inside
+    // them rather than O(n).
+    SearchState& fwd = tracked_state(n, 0);
+    SearchState& bwd = tracked_state(n, 1);
+    SsspOptions opts;
+    double bound_f = B, bound_b = B;
+    opts.bound = B;
+    search(fwd, n, adj, source, opts, nullptr);
+    search(bwd, n, radj, target, opts, nullptr);
+    int round = 1;
+    double best = INF;
+    while (true) {
+        bool grow_f, grow_b;
+        best = meeting_distance(adj, radj, fwd, bwd, grow_f, grow_b);
+
+        // Any shortest path of length L < bound_f + bound_b has an edge
+        // whose tail is below bound_f from source and whose head is below
+        // bound_b from target, so best == L. A ball that cannot grow is
+        // already complete.
+        if (best < bound_f + bound_b || !grow_f || !grow_b)
+            break;
+
+        // Grow the smaller ball: double its bound until the balls meet,
+        // then jump straight to the bound that certifies the current
+        // candidate.
+        round++;
+        bool forward = fwd.reached.size() <= bwd.reached.size();
+        double& bound = forward ? bound_f : bound_b;
+        double other = forward ? bound_b : bound_f;
+        if (best == INF) {
+            bound *= 2;
+        } else {
+            bound = nextafter(best - other, INF);
+            while (bound + other <= best)
+                bound = nextafter(bound, INF);
+        }
+        opts.bound = bound;
+        if (forward)
+            search(fwd, n, adj, source, opts, nullptr);
+        else
+            search(bwd, n, radj, target, opts, nullptr);
+    }
+    if (rounds)
+        *rounds = round;
+    return best;
 }
@@ -2,11 +2,165 @@
 #define BMSSP_H
 
 #include "types.h"
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <vector>
 
 using namespace std;
 
+struct Landmarks;
+struct CsrView;
+struct CompressedView;
+
+// Outcome of a solve (see SsspOptions::status).
+enum SolveStatus {
+    SOLVE_COMPLETE = 0,
+    SOLVE_CANCELLED,
+    SOLVE_DEADLINE,
+    SOLVE_STOPPED // the settled-node visitor returned false
+};
+
+// Receives a node and its final distance; returning false stops the solve.
+using SettledVisitor = function<bool(vertex_t node, double dist)>;
+
+// Cooperative cancellation flag shared by a caller and the solves it
+// started. cancel() may be called from any thread.
+struct CancelToken {
+    atomic<bool> cancelled{false};
+
+    void cancel() { cancelled.store(true, memory_order_relaxed); }
+    bool is_cancelled() const {
+        return cancelled.load(memory_order_relaxed);
+    }
+};
+
+struct SsspOptions {
+    // Only distances strictly below `bound` are computed, every other node
+    // is reported as infinity.
+    double bound = numeric_limits<double>::infinity();
+
+    // Point-to-point mode: with a target and landmark tables, relaxations
+    // whose landmark lower bound shows they cannot shorten the path to
+    // `target` are pruned. Only the target's distance is exact then.
+    vertex_t target = -1;
+    const Landmarks* landmarks = nullptr;
+
+    // Relaxation loops prefetch the distance label this many edges ahead
+    // (and the next node's edge row). 0 disables prefetching.
+    int prefetch_distance = 0;
+
+    // Deterministic parallel mode with this many threads (0 = the plain
+    // sequential solver). Edge relaxations of find_pivots and of the
+    // BlockList phase are proposed in parallel and reduced in (target,
+    // distance, predecessor id) order, so distances and predecessors are
+    // bit-identical for every thread count >= 1.
+    int threads = 0;
+
+    // Strict-improvement mode: a relaxation that only ties a node's label
+    // does not requeue a node already expanded at that label (a node in the
+    // current find_pivots forest, or one settled in the current base case).
+    // Saves the repeated work of zero-weight edges and tied paths; distances
+    // are the same as without it.
+    bool strict = false;
+
+    // When set, receives the predecessor of every node on its shortest path
+    // (-1 for the source and unreached nodes).
+    vector<vertex_t>* parents = nullptr;
+
+    // Cooperative stop: the token and the deadline are checked before every
+    // BlockList pull and every base case pop. A stopped solve unwinds at
+    // once and returns the distances proven so far (the nodes settled by
+    // completed base cases and recursion levels, and the tree paths leading
+    // to them); every other node is reported as infinity.
+    const CancelToken* cancel = nullptr;
+    chrono::steady_clock::time_point deadline =
+        chrono::steady_clock::time_point::max();
+
+    // When set, receives whether the solve ran to completion.
+    SolveStatus* status = nullptr;
+
+    // Called once for every node below the bound, as soon as its distance
+    // is proven: the source first, then each node settled by a base case or
+    // returned by a completed recursion level. Nodes arrive roughly, but
+    // not exactly, in distance order. Returning false stops the solve like
+    // a cancellation (status SOLVE_STOPPED). With a target and landmarks,
+    // only the target's distance is exact.
+    SettledVisitor on_settled;
+};
+
 // Solves Single-Source Shortest Path using the BMSSP algorithm
-vector<double> solve_sssp(int n, const vector<vector<Edge>>& adj, int start);
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start);
+
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start, double bound);
+
+vector<double> solve_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                          vertex_t start, const SsspOptions& opts);
+
+// Same search on a CSR graph (see csr_graph.h).
+vector<double> solve_sssp(const CsrView& graph, vertex_t start,
+                          const SsspOptions& opts = SsspOptions());
+
+// Same search on a compressed graph, decoding rows as they are relaxed
+// (see compressed_graph.h).
+vector<double> solve_sssp(const CompressedView& graph, vertex_t start,
+                          const SsspOptions& opts = SsspOptions());
+
+// Streams the search to `visitor` (see SsspOptions::on_settled) without
+// building the distance vector.
+SolveStatus visit_sssp(vertex_t n, const vector<vector<Edge>>& adj,
+                       vertex_t start,
+                       const SettledVisitor& visitor,
+                       SsspOptions opts = SsspOptions());
+SolveStatus visit_sssp(const CsrView& graph, vertex_t start,
+                       const SettledVisitor& visitor,
+                       SsspOptions opts = SsspOptions());
+SolveStatus visit_sssp(const CompressedView& graph, vertex_t start,
+                       const SettledVisitor& visitor,
+                       SsspOptions opts = SsspOptions());
+
+// One answer of a k-nearest query.
+struct Neighbor {
+    vertex_t node;
+    double dist;
+};
+
+// The k nodes nearest to source, nearest first (ties by id). With
+// `category`, only nodes whose bit is set count (bit v % 64 of word v / 64);
+// the source counts like any other node. Runs bounded solves over a growing
+// ball: each round streams the ball of radius B through the settled-node
+// visitor and stops once k matching nodes are proven; a last round to just
+// past the k-th of them then yields the exact answer. When a round ends
+// with fewer matches, B at least doubles and always passes the cheapest
+// label just outside the ball, so the next round gains a node. Rounds reuse
+// per-thread label arrays and reset only what the previous search touched,
+// so after the first query on a graph of this size a query costs the work
+// inside its ball (the arrays, O(n), are kept until a query on a graph of
+// another size). opts.bound caps the radius (fewer than k answers then);
+// threads, strict, prefetching and stop sources apply to every round, and
+// opts.parents is ignored. After a stop (see opts.status) the answers are
+// proven distances but need not be the nearest. `rounds` receives the
+// number of solves.
+vector<Neighbor> nearest_k(vertex_t n, const vector<vector<Edge>>& adj,
+                           vertex_t source, int k, const uint64_t* category = nullptr,
+                           SsspOptions opts = SsspOptions(),
+                           int* rounds = nullptr);
+vector<Neighbor> nearest_k(const CsrView& graph, vertex_t source, int k,
+                           const uint64_t* category = nullptr,
+                           SsspOptions opts = SsspOptions(),
+                           int* rounds = nullptr);
+
+// Bidirectional point-to-point query built from bounded BMSSP runs on adj
+// and its transpose radj. Each round grows the smaller of the two balls
+// until the best meeting distance over edges joining them is below the sum
+// of their bounds, which proves it optimal. `rounds` receives the number
+// of bound steps.
+double bidirectional_bmssp(vertex_t n, const vector<vector<Edge>>& adj,
+                           const vector<vector<Edge>>& radj, vertex_t source,
+                           vertex_t target, int* rounds = nullptr);
 
 #endif // BMSSP_H
@@ -0,0 +1,252 @@
+#include "bmssp_capi.h"
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+struct bmssp_graph {
+    CsrView view;
+};
+
+struct bmssp_cancel_token {
+    CancelToken token;
+};
+
+// Runs body, mapping exceptions to status codes: nothing may unwind
+// through the C interface.
+template <class Body> static bmssp_status guarded(Body body) {
+    try {
+        return body();
+    } catch (const bad_alloc&) {
+        return BMSSP_OUT_OF_MEMORY;
+    } catch (...) {
+        return BMSSP_INTERNAL_ERROR;
+    }
+}
+
+// Copies the caller's options, accepting structs from older headers that
+// end before the newer fields.
+static bmssp_options read_options(const bmssp_options* opts) {
+    bmssp_options out;
+    bmssp_options_init(&out);
+    if (opts)
+        memcpy(&out, opts, min(opts->size, sizeof(out)));
+    return out;
+}
+
+// The deadline is fixed once per call, so a batch shares one budget.
+static SsspOptions to_sssp_options(const bmssp_options& opts) {
+    SsspOptions out;
+    out.bound = opts.bound;
+    out.threads = max(0, opts.threads);
+    out.prefetch_distance = max(0, opts.prefetch_distance);
+    out.strict = opts.strict != 0;
+    if (opts.cancel)
+        out.cancel = &opts.cancel->token;
+    if (opts.time_limit_ms > 0)
+        out.deadline = chrono::steady_clock::now() +
+                       chrono::duration_cast<chrono::steady_clock::duration>(
+                           chrono::duration<double, milli>(opts.time_limit_ms));
+    return out;
+}
+
+static bool is_stop(int status) {
+    return status == BMSSP_CANCELLED || status == BMSSP_DEADLINE_EXCEEDED;
+}
+
+static bmssp_status to_status(SolveStatus status) {
+    switch (status) {
+    case SOLVE_CANCELLED:
+        return BMSSP_CANCELLED;
+    case SOLVE_DEADLINE:
+        return BMSSP_DEADLINE_EXCEEDED;
+    default:
+        return BMSSP_OK;
+    }
+}
+
+int bmssp_api_version(void) {
+    return BMSSP_API_VERSION;
+}
+
+void bmssp_options_init(bmssp_options* opts) {
+    if (!opts)
+        return;
+    memset(opts, 0, sizeof(*opts));
+    opts->size = sizeof(*opts);
+    opts->bound = numeric_limits<double>::infinity();
+}
+
+const char* bmssp_status_string(bmssp_status status) {
+    switch (status) {
+    case BMSSP_OK:
+        return "ok";
+    case BMSSP_INVALID_ARGUMENT:
+        return "invalid argument";
+    case BMSSP_OUT_OF_MEMORY:
+        return "out of memory";
+    case BMSSP_INTERNAL_ERROR:
+        return "internal error";
+    case BMSSP_CANCELLED:
+        return "cancelled";
+    case BMSSP_DEADLINE_EXCEEDED:
+        return "deadline exceeded";
+    }
+    return "unknown status";
+}
+
+bmssp_status bmssp_graph_create(int32_t n, const int64_t* offsets,
+                                const int32_t* targets, const double* weights,
+                                bmssp_graph** out) {
+    if (!out)
+        return BMSSP_INVALID_ARGUMENT;
+    *out = nullptr;
+    CsrView view = {n, offsets, targets, weights};
+    if (!valid_csr(view))
+        return BMSSP_INVALID_ARGUMENT;
+
+    return guarded([&] {
+        bmssp_graph* graph = new bmssp_graph;
+        graph->view = view;
+        *out = graph;
+        return BMSSP_OK;
+    });
+}
+
+void bmssp_graph_free(bmssp_graph* graph) {
+    delete graph;
+}
+
+int32_t bmssp_graph_node_count(const bmssp_graph* graph) {
+    return graph ? graph->view.n : 0;
+}
+
+bmssp_status bmssp_cancel_token_create(bmssp_cancel_token** out) {
+    if (!out)
+        return BMSSP_INVALID_ARGUMENT;
+    *out = nullptr;
+    return guarded([&] {
+        *out = new bmssp_cancel_token;
+        return BMSSP_OK;
+    });
+}
+
+void bmssp_cancel_token_cancel(bmssp_cancel_token* token) {
+    if (token)
+        token->token.cancel();
+}
+
+void bmssp_cancel_token_free(bmssp_cancel_token* token) {
+    delete token;
+}
+
+bmssp_status bmssp_solve(const bmssp_graph* graph, int32_t source,
+                         const bmssp_options* opts, double* dist,
+                         int32_t* parents) {
+    if (!graph || !dist || source < 0 || source >= graph->view.n)
+        return BMSSP_INVALID_ARGUMENT;
+    bmssp_options o = read_options(opts);
+    ScopedThreadPinning pin(o.pin_threads != 0);
+    return guarded([&] {
+        SsspOptions sssp = to_sssp_options(o);
+        vector<vertex_t> tree;
+        if (parents)
+            sssp.parents = &tree;
+        SolveStatus status;
+        sssp.status = &status;
+        vector<double> result = solve_sssp(graph->view, source, sssp);
+        copy(result.begin(), result.end(), dist);
+        if (parents)
+            copy(tree.begin(), tree.end(), parents);
+        return to_status(status);
+    });
+}
+
+bmssp_status bmssp_solve_batch(const bmssp_graph* graph,
+                               const int32_t* sources, int32_t count,
+                               const bmssp_options* opts, double* dist) {
+    if (!graph || count < 0 || (count > 0 && (!sources || !dist)))
+        return BMSSP_INVALID_ARGUMENT;
+    for (int32_t i = 0; i < count; ++i)
+        if (sources[i] < 0 || sources[i] >= graph->view.n)
+            return BMSSP_INVALID_ARGUMENT;
+    bmssp_options o = read_options(opts);
+    ScopedThreadPinning pin(o.pin_threads != 0);
+    SsspOptions sssp = to_sssp_options(o);
+    size_t n = (size_t)graph->view.n;
+
+    // Workers cannot throw across parallel_for; the first failure is kept,
+    // and errors win over stops. Solves after a stop still run (and stop at
+    // once) so that every row gets its source.
+    atomic<int> failure(BMSSP_OK);
+    parallel_for(count, max(0, o.batch_threads), [&](int, int i) {
+        int seen = failure.load();
+        if (seen != BMSSP_OK && !is_stop(seen))
+            return;
+        bmssp_status status = guarded([&] {
+            SolveStatus solved;
+            SsspOptions local = sssp;
+            local.status = &solved;
+            vector<double> result = solve_sssp(graph->view, sources[i], local);
+            copy(result.begin(), result.end(), dist + i * n);
+            return to_status(solved);
+        });
+        int expected = BMSSP_OK;
+        if (is_stop(status))
+            failure.compare_exchange_strong(expected, status);
+        else if (status != BMSSP_OK)
+            failure.store(status);
+    });
+    return (bmssp_status)failure.load();
+}
+
+bmssp_status bmssp_visit(const bmssp_graph* graph, int32_t source,
+                         const bmssp_options* opts, bmssp_visit_fn visit,
+                         void* context) {
+    if (!graph || !visit || source < 0 || source >= graph->view.n)
+        return BMSSP_INVALID_ARGUMENT;
+    bmssp_options o = read_options(opts);
+    ScopedThreadPinning pin(o.pin_threads != 0);
+    return guarded([&] {
+        SolveStatus status = visit_sssp(
+            graph->view, source,
+            [&](vertex_t node, double dist) {
+                return visit(context, node, dist) != 0;
+            },
+            to_sssp_options(o));
+        return status == SOLVE_STOPPED ? BMSSP_OK : to_status(status);
+    });
+}
+
+bmssp_status bmssp_nearest(const bmssp_graph* graph, int32_t source,
+                           int32_t k, const uint64_t* category,
+                           const bmssp_options* opts, int32_t* nodes,
+                           double* dist, int32_t* found) {
+    if (!graph || !found || k < 0 || (k > 0 && (!nodes || !dist)) ||
+        source < 0 || source >= graph->view.n)
+        return BMSSP_INVALID_ARGUMENT;
+    *found = 0;
+    bmssp_options o = read_options(opts);
+    ScopedThreadPinning pin(o.pin_threads != 0);
+    return guarded([&] {
+        SsspOptions sssp = to_sssp_options(o);
+        SolveStatus status;
+        sssp.status = &status;
+        vector<Neighbor> result =
+            nearest_k(graph->view, source, k, category, sssp);
+        for (size_t i = 0; i < result.size(); ++i) {
+            nodes[i] = result[i].node;
+            dist[i] = result[i].dist;
+        }
+        *found = (int32_t)result.size();
+        return to_status(status);
+    });
+}
@@ -0,0 +1,146 @@
+#ifndef BMSSP_CAPI_H
+#define BMSSP_CAPI_H
+
+/* C interface of libbmssp. Every function is callable from C and C++;
+ * errors are returned as status codes, never thrown. Types and functions
+ * are only ever added, and bmssp_options grows at its end only (callers
+ * pass its size), so code built against an older header keeps working. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#define BMSSP_API __declspec(dllexport)
+#elif defined(__GNUC__) || defined(__clang__)
+#define BMSSP_API __attribute__((visibility("default")))
+#else
+#define BMSSP_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BMSSP_API_VERSION 2
+
+typedef enum {
+    BMSSP_OK = 0,
+    BMSSP_INVALID_ARGUMENT = 1, /* null pointer, bad CSR arrays or source */
+    BMSSP_OUT_OF_MEMORY = 2,
+    BMSSP_INTERNAL_ERROR = 3,
+    /* The solve was stopped; dist holds the distances proven so far and
+     * INFINITY elsewhere. */
+    BMSSP_CANCELLED = 4,
+    BMSSP_DEADLINE_EXCEEDED = 5
+} bmssp_status;
+
+typedef struct bmssp_graph bmssp_graph;
+
+/* Cancellation flag shared between a caller and its running solves. */
+typedef struct bmssp_cancel_token bmssp_cancel_token;
+
+typedef struct {
+    size_t size; /* sizeof(bmssp_options), set by bmssp_options_init */
+
+    /* Only distances strictly below bound are computed; every other node
+     * gets INFINITY. */
+    double bound;
+
+    /* Deterministic parallel relaxation inside one solve (0 = sequential).
+     * Results do not depend on the value. */
+    int32_t threads;
+
+    /* Edges of label prefetch lookahead, 0 disables prefetching. */
+    int32_t prefetch_distance;
+
+    /* Non-zero skips redundant equal-distance relaxations. */
+    int32_t strict;
+
+    /* Sources solved at once by bmssp_solve_batch (0 = all hardware
+     * threads). */
+    int32_t batch_threads;
+
+    /* Time budget of the whole call in milliseconds, 0 for none. */
+    double time_limit_ms;
+
+    /* Solves stop soon after the token is cancelled; null for none. */
+    const bmssp_cancel_token* cancel;
+
+    /* Non-zero pins the worker threads of the call, worker w to the w-th
+     * CPU of the process affinity mask. Other calls are not affected. */
+    int32_t pin_threads;
+} bmssp_options;
+
+BMSSP_API int bmssp_api_version(void);
+
+/* Fills opts with the defaults: unbounded, sequential, no prefetching,
+ * unpinned. */
+BMSSP_API void bmssp_options_init(bmssp_options* opts);
+
+BMSSP_API const char* bmssp_status_string(bmssp_status status);
+
+/* Wraps a caller-owned CSR graph without copying it: the edges of node u
+ * are at [offsets[u], offsets[u + 1]) of targets and weights. The arrays
+ * must stay valid and unchanged until bmssp_graph_free. They are checked
+ * once here: offsets[0] == 0 and non-decreasing, targets in [0, n),
+ * weights non-negative. */
+BMSSP_API bmssp_status bmssp_graph_create(int32_t n, const int64_t* offsets,
+                                          const int32_t* targets,
+                                          const double* weights,
+                                          bmssp_graph** out);
+
+BMSSP_API void bmssp_graph_free(bmssp_graph* graph);
+
+BMSSP_API int32_t bmssp_graph_node_count(const bmssp_graph* graph);
+
+BMSSP_API bmssp_status bmssp_cancel_token_create(bmssp_cancel_token** out);
+
+/* May be called from any thread, also while solves are running. */
+BMSSP_API void bmssp_cancel_token_cancel(bmssp_cancel_token* token);
+
+BMSSP_API void bmssp_cancel_token_free(bmssp_cancel_token* token);
+
+/* Distances from source into dist[n]. parents may be null; otherwise it
+ * receives the shortest path tree (-1 for the source and unreached nodes).
+ * opts may be null for the defaults. A graph may be solved from several
+ * threads at once. */
+BMSSP_API bmssp_status bmssp_solve(const bmssp_graph* graph, int32_t source,
+                                   const bmssp_options* opts, double* dist,
+                                   int32_t* parents);
+
+/* Solves count sources concurrently; the distances of sources[i] go to
+ * dist[i * n, (i + 1) * n). Fails without solving if any source is out of
+ * range. After a stop, the remaining rows hold only their source. */
+BMSSP_API bmssp_status bmssp_solve_batch(const bmssp_graph* graph,
+                                         const int32_t* sources,
+                                         int32_t count,
+                                         const bmssp_options* opts,
+                                         double* dist);
+
+/* Receives a node and its final distance; returning 0 stops the solve. */
+typedef int (*bmssp_visit_fn)(void* context, int32_t node, double dist);
+
+/* Streams the solve instead of writing a distance array: visit is called
+ * once for every node below the bound as soon as its distance is proven,
+ * the source first, roughly in distance order. Stopping from visit still
+ * returns BMSSP_OK. */
+BMSSP_API bmssp_status bmssp_visit(const bmssp_graph* graph, int32_t source,
+                                   const bmssp_options* opts,
+                                   bmssp_visit_fn visit, void* context);
+
+/* The k nodes nearest to source, nearest first: writes up to k entries to
+ * nodes and dist and their number to found. category may be null;
+ * otherwise only nodes whose bit is set count (bit v % 64 of
+ * category[v / 64]). opts.bound caps the search radius. */
+BMSSP_API bmssp_status bmssp_nearest(const bmssp_graph* graph,
+                                     int32_t source, int32_t k,
+                                     const uint64_t* category,
+                                     const bmssp_options* opts,
+                                     int32_t* nodes, double* dist,
+                                     int32_t* found);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BMSSP_CAPI_H */
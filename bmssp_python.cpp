@@ -0,0 +1,322 @@
+// CPython extension module `bmssp`: solves on CSR arrays handed in through
+// the buffer protocol (NumPy arrays, array.array, memoryviews) and returns
+// distances in buffers that NumPy wraps without copying.
+//
+//   g = bmssp.Graph(offsets, targets, weights)  # int64, int32, float64
+//   dist = np.asarray(g.solve(0))
+//   dist, parents = g.solve(0, bound=50.0, parents=True)
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "bmssp.h"
+#include "csr_graph.h"
+#include <cstring>
+#include <limits>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+// Result array owning the vector the solver returned. Exactly one of the
+// two pointers is set.
+struct ArrayObject {
+    PyObject_HEAD
+    vector<double>* doubles;
+    vector<int32_t>* ints;
+    Py_ssize_t length; // exported as the buffer shape
+};
+
+static Py_ssize_t array_length(PyObject* self) {
+    return ((ArrayObject*)self)->length;
+}
+
+static PyObject* array_item(PyObject* self, Py_ssize_t i) {
+    ArrayObject* a = (ArrayObject*)self;
+    if (i < 0 || i >= array_length(self)) {
+        PyErr_SetString(PyExc_IndexError, "index out of range");
+        return nullptr;
+    }
+    if (a->doubles)
+        return PyFloat_FromDouble((*a->doubles)[i]);
+    return PyLong_FromLong((*a->ints)[i]);
+}
+
+static int array_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    ArrayObject* a = (ArrayObject*)self;
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = a->doubles ? (void*)a->doubles->data()
+                : a->ints  ? (void*)a->ints->data()
+                           : nullptr;
+    view->itemsize = a->doubles ? sizeof(double) : sizeof(int32_t);
+    view->len = a->length * view->itemsize;
+    view->readonly = 0;
+    view->format = nullptr;
+    if (flags & PyBUF_FORMAT)
+        view->format = (char*)(a->doubles ? "d" : "i");
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &a->length : nullptr;
+    view->strides =
+        (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &view->itemsize : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+}
+
+static void array_dealloc(PyObject* self) {
+    ArrayObject* a = (ArrayObject*)self;
+    PyTypeObject* type = Py_TYPE(self);
+    delete a->doubles;
+    delete a->ints;
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyType_Slot array_slots[] = {
+    {Py_tp_doc, (void*)"Solver output; supports the buffer protocol."},
+    {Py_tp_dealloc, (void*)array_dealloc},
+    {Py_sq_length, (void*)array_length},
+    {Py_sq_item, (void*)array_item},
+    {Py_bf_getbuffer, (void*)array_getbuffer},
+    {0, nullptr}};
+
+#ifdef Py_TPFLAGS_DISALLOW_INSTANTIATION
+static const unsigned ARRAY_FLAGS =
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION;
+#else
+static const unsigned ARRAY_FLAGS = Py_TPFLAGS_DEFAULT;
+#endif
+
+static PyType_Spec array_spec = {"bmssp.Array", sizeof(ArrayObject), 0,
+                                 ARRAY_FLAGS, array_slots};
+
+static PyTypeObject* array_type = nullptr;
+
+// Takes ownership of the vector; deletes it when the object cannot be made.
+template <class T>
+static PyObject* wrap_vector(vector<T>* values, vector<T>* ArrayObject::*slot) {
+    ArrayObject* a = PyObject_New(ArrayObject, array_type);
+    if (!a) {
+        delete values;
+        return nullptr;
+    }
+    a->doubles = nullptr;
+    a->ints = nullptr;
+    a->*slot = values;
+    a->length = (Py_ssize_t)values->size();
+    return (PyObject*)a;
+}
+
+// Graph over caller-owned arrays. The buffers stay acquired for the
+// lifetime of the object, which keeps them alive and unresizable.
+struct GraphObject {
+    PyObject_HEAD
+    Py_buffer buffers[3];
+    int acquired;
+    CsrView view;
+};
+
+// Acquires a contiguous one-dimensional buffer of `kind` ('i' for signed
+// integers, 'f' for floats) with elements of `itemsize` bytes.
+static bool get_array(PyObject* obj, Py_buffer* buf, char kind,
+                      Py_ssize_t itemsize, const char* name) {
+    if (PyObject_GetBuffer(obj, buf, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+        return false;
+    const char* format = buf->format ? buf->format : "B";
+    if (*format == '@' || *format == '=' || *format == '<')
+        ++format;
+    bool ok = buf->ndim <= 1 && buf->itemsize == itemsize && format[1] == 0;
+    if (kind == 'i')
+        ok = ok && strchr("bhilq", format[0]) != nullptr;
+    else
+        ok = ok && format[0] == 'd';
+    if (!ok) {
+        PyErr_Format(PyExc_TypeError,
+                     "%s must be a contiguous 1-d array of %s%d", name,
+                     kind == 'i' ? "int" : "float", (int)(itemsize * 8));
+        PyBuffer_Release(buf);
+    }
+    return ok;
+}
+
+static int graph_init(PyObject* self, PyObject* args, PyObject* kwds) {
+    GraphObject* g = (GraphObject*)self;
+    static const char* keywords[] = {"offsets", "targets", "weights",
+                                     nullptr};
+    PyObject* arrays[3];
+    if (g->acquired) {
+        PyErr_SetString(PyExc_RuntimeError, "Graph is already initialized");
+        return -1;
+    }
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OOO", (char**)keywords,
+                                     &arrays[0], &arrays[1], &arrays[2]))
+        return -1;
+    static const char kinds[3] = {'i', 'i', 'f'};
+    static const Py_ssize_t sizes[3] = {sizeof(edge_t), sizeof(vertex_t),
+                                        sizeof(double)};
+    for (; g->acquired < 3; ++g->acquired)
+        if (!get_array(arrays[g->acquired], &g->buffers[g->acquired],
+                       kinds[g->acquired], sizes[g->acquired],
+                       keywords[g->acquired]))
+            return -1;
+
+    Py_ssize_t count = g->buffers[0].len / (Py_ssize_t)sizeof(edge_t);
+    if (count < 1 || count - 1 > numeric_limits<vertex_t>::max()) {
+        PyErr_SetString(PyExc_ValueError,
+                        "offsets must have between 1 and 2**31 entries");
+        return -1;
+    }
+    g->view.n = (vertex_t)(count - 1);
+    g->view.offsets = (const edge_t*)g->buffers[0].buf;
+    g->view.targets = (const vertex_t*)g->buffers[1].buf;
+    g->view.weights = (const double*)g->buffers[2].buf;
+    Py_ssize_t m = g->view.offsets[g->view.n];
+    if (m < 0 ||
+        g->buffers[1].len / (Py_ssize_t)sizeof(vertex_t) < m ||
+        g->buffers[2].len / (Py_ssize_t)sizeof(double) < m ||
+        !valid_csr(g->view)) {
+        PyErr_SetString(PyExc_ValueError,
+                        "invalid CSR arrays: offsets must start at 0 and "
+                        "never decrease, targets lie in [0, n) and weights "
+                        "be non-negative");
+        g->view = CsrView();
+        return -1;
+    }
+    return 0;
+}
+
+static void graph_dealloc(PyObject* self) {
+    GraphObject* g = (GraphObject*)self;
+    PyTypeObject* type = Py_TYPE(self);
+    for (int i = 0; i < g->acquired; ++i)
+        PyBuffer_Release(&g->buffers[i]);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyObject* graph_solve(PyObject* self, PyObject* args, PyObject* kwds) {
+    GraphObject* g = (GraphObject*)self;
+    static const char* keywords[] = {"source",   "bound",   "threads",
+                                     "prefetch", "strict",  "parents",
+                                     nullptr};
+    int source;
+    double bound = numeric_limits<double>::infinity();
+    int threads = 0, prefetch = 0, strict = 0, want_parents = 0;
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "i|$diipp", (char**)keywords,
+                                     &source, &bound, &threads, &prefetch,
+                                     &strict, &want_parents))
+        return nullptr;
+    if (source < 0 || source >= g->view.n) {
+        PyErr_SetString(PyExc_ValueError, "source out of range");
+        return nullptr;
+    }
+
+    SsspOptions opts;
+    opts.bound = bound;
+    opts.threads = threads < 0 ? 0 : threads;
+    opts.prefetch_distance = prefetch < 0 ? 0 : prefetch;
+    opts.strict = strict != 0;
+    vector<double>* dist = nullptr;
+    vector<int32_t>* parents = nullptr;
+    bool failed = false;
+    Py_BEGIN_ALLOW_THREADS
+    try {
+        dist = new vector<double>();
+        if (want_parents) {
+            parents = new vector<int32_t>();
+            opts.parents = parents;
+        }
+        *dist = solve_sssp(g->view, source, opts);
+    } catch (...) {
+        failed = true;
+    }
+    Py_END_ALLOW_THREADS
+    if (failed) {
+        delete dist;
+        delete parents;
+        return PyErr_NoMemory();
+    }
+
+    PyObject* dist_array = wrap_vector(dist, &ArrayObject::doubles);
+    if (!want_parents || !dist_array) {
+        if (!dist_array)
+            delete parents;
+        return dist_array;
+    }
+    PyObject* parent_array = wrap_vector(parents, &ArrayObject::ints);
+    if (!parent_array) {
+        Py_DECREF(dist_array);
+        return nullptr;
+    }
+    PyObject* result = PyTuple_Pack(2, dist_array, parent_array);
+    Py_DECREF(dist_array);
+    Py_DECREF(parent_array);
+    return result;
+}
+
+static PyObject* graph_node_count(PyObject* self, void*) {
+    return PyLong_FromLong(((GraphObject*)self)->view.n);
+}
+
+static PyObject* graph_edge_count(PyObject* self, void*) {
+    return PyLong_FromLongLong(((GraphObject*)self)->view.edge_count());
+}
+
+static PyMethodDef graph_methods[] = {
+    {"solve", (PyCFunction)(void (*)(void))graph_solve,
+     METH_VARARGS | METH_KEYWORDS,
+     "solve(source, *, bound=inf, threads=0, prefetch=0, strict=False, "
+     "parents=False)\n\n"
+     "Distances from source as a float64 buffer (inf when unreached), plus\n"
+     "the int32 shortest path tree when parents=True. Runs without the GIL."},
+    {nullptr, nullptr, 0, nullptr}};
+
+static PyGetSetDef graph_getset[] = {
+    {"node_count", graph_node_count, nullptr, nullptr, nullptr},
+    {"edge_count", graph_edge_count, nullptr, nullptr, nullptr},
+    {nullptr, nullptr, nullptr, nullptr, nullptr}};
+
+static PyType_Slot graph_slots[] = {
+    {Py_tp_doc, (void*)"Graph(offsets, targets, weights)\n\n"
+                       "CSR graph over int64 offsets (n + 1), int32 targets "
+                       "and float64\nweights. The arrays are used in place, "
+                       "not copied."},
+    {Py_tp_new, (void*)PyType_GenericNew},
+    {Py_tp_init, (void*)graph_init},
+    {Py_tp_dealloc, (void*)graph_dealloc},
+    {Py_tp_methods, (void*)graph_methods},
+    {Py_tp_getset, (void*)graph_getset},
+    {0, nullptr}};
+
+static PyType_Spec graph_spec = {"bmssp.Graph", sizeof(GraphObject), 0,
+                                 Py_TPFLAGS_DEFAULT, graph_slots};
+
+static PyModuleDef module_def = {PyModuleDef_HEAD_INIT,
+                                 "bmssp",
+                                 "BMSSP single-source shortest paths.",
+                                 -1,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr,
+                                 nullptr};
+
+PyMODINIT_FUNC PyInit_bmssp(void) {
+    PyObject* module = PyModule_Create(&module_def);
+    if (!module)
+        return nullptr;
+    // array_type keeps its own reference for wrap_vector; the module adds
+    // one per type.
+    array_type = (PyTypeObject*)PyType_FromSpec(&array_spec);
+    PyTypeObject* graph_type = (PyTypeObject*)PyType_FromSpec(&graph_spec);
+    bool ok = array_type && graph_type &&
+              PyModule_AddType(module, array_type) == 0 &&
+              PyModule_AddType(module, graph_type) == 0;
+    Py_XDECREF(graph_type);
+    if (!ok) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    return module;
+}
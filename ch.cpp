@@ -0,0 +1,439 @@
+#include "ch.h"
+#include "graph_io.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <queue>
+
+#include <sys/stat.h>
+
+using namespace std;
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Witness searches stop after settling this many nodes; a missed witness
+// only costs an unnecessary shortcut, never a wrong distance. Priority
+// estimates use a cheaper search than the actual contraction.
+static const int WITNESS_SETTLE_LIMIT = 500;
+static const int PRIORITY_SETTLE_LIMIT = 50;
+
+namespace {
+
+// Graph being contracted. Rows keep at most one edge per neighbor (the
+// lightest); edges to contracted nodes are skipped lazily.
+struct ContractionGraph {
+    vector<vector<Edge>> out, in;
+    vector<char> contracted;
+
+    // Scratch state for witness searches, reset through `touched`.
+    vector<double> dist;
+    vector<int> touched;
+
+    ContractionGraph(int n, const vector<vector<Edge>>& adj)
+        : out(n), in(n), contracted(n, 0), dist(n, INF) {
+        for (int u = 0; u < n; ++u)
+            for (const auto& e : adj[u])
+                if (e.to != u)
+                    add_edge(u, e.to, e.weight);
+    }
+
+    static bool update_row(vector<Edge>& row, int to, double w) {
+        for (auto& e : row) {
+            if (e.to == to) {
+                if (w >= e.weight)
+                    return false;
+                e.weight = w;
+                return true;
+            }
+        }
+        row.push_back({to, w});
+        return true;
+    }
+
+    void add_edge(int u, int x, double w) {
+        if (update_row(out[u], x, w))
+            update_row(in[x], u, w);
+    }
+
+    // Dijkstra from `source` over uncontracted nodes, never entering
+    // `avoid`, up to distance `limit`. Results stay in `dist` until the
+    // next call.
+    void witness_search(int source, int avoid, double limit, int max_settled) {
+        for (int v : touched)
+            dist[v] = INF;
+        touched.clear();
+
+        priority_queue<State, vector<State>, greater<State>> pq;
+        dist[source] = 0;
+        touched.push_back(source);
+        pq.push({source, 0});
+        int settled = 0;
+
+        while (!pq.empty() && settled < max_settled) {
+            State cur = pq.top();
+            pq.pop();
+            if (cur.cost > dist[cur.node_id])
+                continue;
+            if (cur.cost > limit)
+                break;
+            settled++;
+            for (const auto& e : out[cur.node_id]) {
+                if (e.to == avoid || contracted[e.to])
+                    continue;
+                double d = cur.cost + e.weight;
+                if (d < dist[e.to]) {
+                    if (dist[e.to] == INF)
+                        touched.push_back(e.to);
+                    dist[e.to] = d;
+                    pq.push({e.to, d});
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to contract v; appended to `shortcuts` when given.
+    int count_shortcuts(int v, vector<pair<int, Edge>>* shortcuts,
+                        int max_settled) {
+        int count = 0;
+        double max_out = 0;
+        for (const auto& e : out[v])
+            if (!contracted[e.to])
+                max_out = max(max_out, e.weight);
+
+        for (const auto& ein : in[v]) {
+            int u = ein.to;
+            if (contracted[u])
+                continue;
+            witness_search(u, v, ein.weight + max_out, max_settled);
+            for (const auto& eout : out[v]) {
+                int x = eout.to;
+                if (contracted[x] || x == u)
+                    continue;
+                double via = ein.weight + eout.weight;
+                if (dist[x] <= via)
+                    continue;
+                count++;
+                if (shortcuts)
+                    shortcuts->push_back({u, {x, via}});
+            }
+        }
+        return count;
+    }
+
+    int live_degree(int v) const {
+        int deg = 0;
+        for (const auto& e : out[v])
+            deg += !contracted[e.to];
+        for (const auto& e : in[v])
+            deg += !contracted[e.to];
+        return deg;
+    }
+
+    // Edge difference plus the number of already contracted neighbors,
+    // which spreads contraction evenly over the graph.
+    int priority(int v, const vector<int>& deleted_neighbors) {
+        return count_shortcuts(v, nullptr, PRIORITY_SETTLE_LIMIT) -
+               live_degree(v) +
+               deleted_neighbors[v];
+    }
+};
+
+} // namespace
+
+ContractionHierarchy build_ch(vertex_t n, const vector<vector<Edge>>& adj) {
+    ContractionHierarchy ch;
+    ch.n = n;
+    ch.rank.assign(n, -1);
+    ch.up.assign(n, {});
+    ch.down.assign(n, {});
+
+    ContractionGraph g(n, adj);
+    vector<int> deleted_neighbors(n, 0);
+
+    using Item = pair<int, int>; // (priority, node)
+    priority_queue<Item, vector<Item>, greater<Item>> pq;
+    for (int v = 0; v < n; ++v)
+        pq.push({g.priority(v, deleted_neighbors), v});
+
+    int next_rank = 0;
+    vector<pair<int, Edge>> shortcuts;
+    while (!pq.empty()) {
+        int v = pq.top().second;
+        pq.pop();
+        if (g.contracted[v])
+            continue;
+
+        // Lazy update: re-queue when the priority got worse than the next
+        // candidate's.
+        int prio = g.priority(v, deleted_neighbors);
+        if (!pq.empty() && prio > pq.top().first) {
+            pq.push({prio, v});
+            continue;
+        }
+
+        shortcuts.clear();
+        g.count_shortcuts(v, &shortcuts, WITNESS_SETTLE_LIMIT);
+
+        // Edges to still uncontracted neighbors point upward in rank.
+        for (const auto& e : g.out[v])
+            if (!g.contracted[e.to])
+                ch.up[v].push_back(e);
+        for (const auto& e : g.in[v])
+            if (!g.contracted[e.to])
+                ch.down[v].push_back(e);
+
+        g.contracted[v] = 1;
+        ch.rank[v] = next_rank++;
+        for (const auto& sc : shortcuts) {
+            g.add_edge(sc.first, sc.second.to, sc.second.weight);
+            ch.shortcuts++;
+        }
+        for (const auto& e : g.out[v])
+            if (!g.contracted[e.to])
+                deleted_neighbors[e.to]++;
+        for (const auto& e : g.in[v])
+            if (!g.contracted[e.to])
+                deleted_neighbors[e.to]++;
+    }
+    return ch;
+}
+
+namespace {
+
+const char CH_MAGIC[4] = {'C', 'H', 'R', 'K'};
+
+} // namespace
+
+bool write_ch(const string& path, const ContractionHierarchy& ch) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+
+    vector<BinaryEdge> edges;
+    for (int u = 0; u < ch.n; ++u)
+        for (const auto& e : ch.up[u])
+            edges.push_back({u, e.to, e.weight});
+    for (int x = 0; x < ch.n; ++x)
+        for (const auto& e : ch.down[x])
+            edges.push_back({e.to, x, e.weight});
+
+    if (edges.size() > UINT32_MAX) {
+        fclose(f);
+        return false;
+    }
+    BinaryHeader header = {ch.n, (uint32_t)edges.size(), 0};
+    int64_t shortcuts = ch.shortcuts;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(edges.data(), sizeof(BinaryEdge), edges.size(), f) ==
+                  edges.size() &&
+              fwrite(CH_MAGIC, 1, 4, f) == 4 &&
+              fwrite(&shortcuts, sizeof(shortcuts), 1, f) == 1 &&
+              fwrite(ch.rank.data(), sizeof(int32_t), ch.n, f) ==
+                  (size_t)ch.n;
+    return fclose(f) == 0 && ok;
+}
+
+bool read_ch(const string& path, ContractionHierarchy& ch) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f)
+        return false;
+
+    BinaryHeader header;
+    char magic[4];
+    int64_t shortcuts = 0;
+    vector<BinaryEdge> edges;
+    bool ok = fread(&header, sizeof(header), 1, f) == 1 && header.n >= 0;
+    // A regular file must hold exactly the header, m edges and the trailer;
+    // otherwise the edge list grows only as records arrive, so a corrupt
+    // header cannot demand memory for edges that are not there.
+    struct stat st;
+    if (ok && fstat(fileno(f), &st) == 0 && S_ISREG(st.st_mode))
+        ok = (uint64_t)st.st_size ==
+             sizeof(header) + (uint64_t)header.m * sizeof(BinaryEdge) + 4 +
+                 sizeof(shortcuts) + (uint64_t)header.n * sizeof(int32_t);
+    if (ok) {
+        const size_t chunk = 1 << 20;
+        edges.reserve(min<size_t>(header.m, chunk));
+        for (size_t done = 0; ok && done < header.m;) {
+            size_t count = min<size_t>(header.m - done, chunk);
+            edges.resize(done + count);
+            ok = fread(edges.data() + done, sizeof(BinaryEdge), count, f) ==
+                 count;
+            done += count;
+        }
+        ch.n = header.n;
+        ch.rank.assign(ch.n, -1);
+        ok = ok && fread(magic, 1, 4, f) == 4 &&
+             memcmp(magic, CH_MAGIC, 4) == 0 &&
+             fread(&shortcuts, sizeof(shortcuts), 1, f) == 1 &&
+             fread(ch.rank.data(), sizeof(int32_t), ch.n, f) == (size_t)ch.n;
+    }
+    fclose(f);
+    if (!ok)
+        return false;
+
+    // Ranks must be a permutation of [0, n) for the upward searches to
+    // terminate, and weights must be non-negative like any solver input.
+    vector<char> taken(ch.n, 0);
+    for (vertex_t v = 0; v < ch.n; ++v) {
+        vertex_t r = ch.rank[v];
+        if (r < 0 || r >= ch.n || taken[r])
+            return false;
+        taken[r] = 1;
+    }
+
+    ch.shortcuts = shortcuts;
+    ch.up.assign(ch.n, {});
+    ch.down.assign(ch.n, {});
+    for (const auto& e : edges) {
+        if (e.u < 0 || e.u >= ch.n || e.v < 0 || e.v >= ch.n || !(e.w >= 0))
+            return false;
+        if (ch.rank[e.u] < ch.rank[e.v])
+            ch.up[e.u].push_back({e.v, e.w});
+        else
+            ch.down[e.v].push_back({e.u, e.w});
+    }
+    return true;
+}
+
+ChQuery::ChQuery(const ContractionHierarchy& hierarchy)
+    : ch(hierarchy), dist_f(hierarchy.n, INF), dist_b(hierarchy.n, INF) {}
+
+void ChQuery::reset_forward() {
+    for (vertex_t v : touched_f)
+        dist_f[v] = INF;
+    touched_f.clear();
+}
+
+void ChQuery::reset_backward() {
+    for (vertex_t v : touched_b)
+        dist_b[v] = INF;
+    touched_b.clear();
+}
+
+double ChQuery::distance(vertex_t source, vertex_t target) {
+    reset_forward();
+    reset_backward();
+    settled = 0;
+
+    const vector<vector<Edge>>* graph[2] = {&ch.up, &ch.down};
+    vector<double>* dist[2] = {&dist_f, &dist_b};
+    vector<vertex_t>* touched[2] = {&touched_f, &touched_b};
+    priority_queue<State, vector<State>, greater<State>> pq[2];
+
+    dist_f[source] = 0;
+    touched_f.push_back(source);
+    pq[0].push({source, 0});
+    dist_b[target] = 0;
+    touched_b.push_back(target);
+    pq[1].push({target, 0});
+    double best = source == target ? 0.0 : INF;
+
+    // Each direction stops once its queue minimum reaches the best
+    // meeting distance; the searches only meet at higher-ranked nodes.
+    while (true) {
+        bool live0 = !pq[0].empty() && pq[0].top().cost < best;
+        bool live1 = !pq[1].empty() && pq[1].top().cost < best;
+        if (!live0 && !live1)
+            break;
+        int side = !live1 || (live0 && pq[0].top().cost <= pq[1].top().cost)
+                       ? 0
+                       : 1;
+        State cur = pq[side].top();
+        pq[side].pop();
+        vector<double>& d = *dist[side];
+        if (cur.cost > d[cur.node_id])
+            continue;
+        settled++;
+        best = min(best, cur.cost + (*dist[1 - side])[cur.node_id]);
+
+        for (const auto& e : (*graph[side])[cur.node_id]) {
+            double nd = cur.cost + e.weight;
+            if (nd < d[e.to]) {
+                if (d[e.to] == INF)
+                    touched[side]->push_back(e.to);
+                d[e.to] = nd;
+                pq[side].push({e.to, nd});
+            }
+        }
+    }
+    return best;
+}
+
+void ChQuery::search_all(vertex_t node, const vector<vector<Edge>>& graph,
+                         vector<double>& dist, vector<vertex_t>& touched,
+                         vector<pair<vertex_t, double>>* space) {
+    for (vertex_t v : touched)
+        dist[v] = INF;
+    touched.clear();
+    priority_queue<State, vector<State>, greater<State>> pq;
+    dist[node] = 0;
+    touched.push_back(node);
+    pq.push({node, 0});
+    while (!pq.empty()) {
+        State cur = pq.top();
+        pq.pop();
+        if (cur.cost > dist[cur.node_id])
+            continue;
+        settled++;
+        if (space)
+            space->push_back({cur.node_id, cur.cost});
+        for (const auto& e : graph[cur.node_id]) {
+            double nd = cur.cost + e.weight;
+            if (nd < dist[e.to]) {
+                if (dist[e.to] == INF)
+                    touched.push_back(e.to);
+                dist[e.to] = nd;
+                pq.push({e.to, nd});
+            }
+        }
+    }
+}
+
+void ChQuery::upward_space(vertex_t node, bool backward,
+                           vector<pair<vertex_t, double>>& space) {
+    space.clear();
+    if (backward)
+        search_all(node, ch.down, dist_b, touched_b, &space);
+    else
+        search_all(node, ch.up, dist_f, touched_f, &space);
+}
+
+double ChQuery::search_backward(vertex_t target, double best) {
+    reset_backward();
+    priority_queue<State, vector<State>, greater<State>> pq;
+    dist_b[target] = 0;
+    touched_b.push_back(target);
+    pq.push({target, 0});
+    while (!pq.empty() && pq.top().cost < best) {
+        State cur = pq.top();
+        pq.pop();
+        if (cur.cost > dist_b[cur.node_id])
+            continue;
+        settled++;
+        best = min(best, cur.cost + dist_f[cur.node_id]);
+        for (const auto& e : ch.down[cur.node_id]) {
+            double nd = cur.cost + e.weight;
+            if (nd < dist_b[e.to]) {
+                if (dist_b[e.to] == INF)
+                    touched_b.push_back(e.to);
+                dist_b[e.to] = nd;
+                pq.push({e.to, nd});
+            }
+        }
+    }
+    return best;
+}
+
+vector<double> ChQuery::one_to_many(vertex_t source,
+                                    const vector<vertex_t>& targets) {
+    settled = 0;
+    search_all(source, ch.up, dist_f, touched_f, nullptr);
+    vector<double> result;
+    result.reserve(targets.size());
+    for (vertex_t t : targets)
+        result.push_back(search_backward(t, INF));
+    return result;
+}
@@ -0,0 +1,68 @@
+#ifndef CH_H
+#define CH_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Contraction hierarchy: every node has a rank (its contraction order), and
+// shortest paths are found by two searches that only move upward in rank.
+struct ContractionHierarchy {
+    vertex_t n = 0;
+    vector<vertex_t> rank;
+    vector<vector<Edge>> up;   // u -> x with rank[x] > rank[u]
+    vector<vector<Edge>> down; // at x: edge u -> x with rank[u] > rank[x],
+                               // stored as x -> u for the backward search
+    long long shortcuts = 0;
+};
+
+// Contracts nodes in order of edge difference (lazy updates), adding a
+// shortcut u -> x around v only when a bounded witness search finds no path
+// of equal or smaller length that avoids v.
+ContractionHierarchy build_ch(vertex_t n, const vector<vector<Edge>>& adj);
+
+// The hierarchy is stored in the binary graph format (header, then the
+// upward and downward edges as ordinary u -> v edges) followed by a trailer
+// holding the ranks. The edge part alone is a valid input graph with the
+// same distances as the original. read_ch rejects a file whose size does
+// not match its header, whose ranks are not a permutation or whose weights
+// are negative.
+bool write_ch(const string& path, const ContractionHierarchy& ch);
+bool read_ch(const string& path, ContractionHierarchy& ch);
+
+// Query engine with reusable search state; one instance per thread.
+struct ChQuery {
+    const ContractionHierarchy& ch;
+
+    ChQuery(const ContractionHierarchy& hierarchy);
+
+    double distance(vertex_t source, vertex_t target);
+
+    // Distances from source to each target: one upward search from source,
+    // then one backward upward search per target.
+    vector<double> one_to_many(vertex_t source,
+                               const vector<vertex_t>& targets);
+
+    // Full upward search space of `node`: forward along `up`, or backward
+    // along `down`, as (node, distance) pairs in settle order.
+    void upward_space(vertex_t node, bool backward,
+                      vector<pair<vertex_t, double>>& space);
+
+    // Settled nodes in the last query, both directions.
+    long long settled = 0;
+
+  private:
+    vector<double> dist_f, dist_b;
+    vector<vertex_t> touched_f, touched_b;
+
+    void reset_forward();
+    void reset_backward();
+    void search_all(vertex_t node, const vector<vector<Edge>>& graph,
+                    vector<double>& dist, vector<vertex_t>& touched,
+                    vector<pair<vertex_t, double>>* space);
+    double search_backward(vertex_t target, double best);
+};
+
+#endif // CH_H
@@ -0,0 +1,264 @@
+#include "ch.h"
+#include "many_to_many.h"
+#include "graph_io.h"
+#include "numa_policy.h"
+#include "parallel.h"
+#include "snapshot.h"
+#include "types.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void print_distance(vertex_t s, vertex_t t, double d) {
+    cout << s << " " << t << " ";
+    if (d == numeric_limits<double>::infinity())
+        cout << "INF";
+    else
+        cout << d;
+    cout << endl;
+}
+
+// Reads whitespace-separated node ids; false, with the offending token
+// reported, if one is not an integer or is out of range.
+static bool read_nodes(const char* path, vertex_t n,
+                       vector<vertex_t>& nodes) {
+    ifstream in(path);
+    if (!in)
+        return false;
+    string token;
+    while (in >> token) {
+        char* end = nullptr;
+        long long v = strtoll(token.c_str(), &end, 10);
+        if (*end != '\0' || end == token.c_str()) {
+            cerr << path << ": malformed node id \"" << token << "\"" << endl;
+            return false;
+        }
+        if (v < 0 || v >= n) {
+            cerr << path << ": node " << token << " out of range" << endl;
+            return false;
+        }
+        nodes.push_back((vertex_t)v);
+    }
+    return true;
+}
+
+// Many-to-many mode: the full origin x destination table.
+static int run_table(const ContractionHierarchy& ch, const char* origin_path,
+                     const char* dest_path, const char* matrix_out,
+                     int threads, bool quiet) {
+    vector<vertex_t> origins, destinations;
+    if (!read_nodes(origin_path, ch.n, origins) ||
+        !read_nodes(dest_path, ch.n, destinations)) {
+        cerr << "Cannot read origin/destination node lists" << endl;
+        return 1;
+    }
+
+    auto start_time = chrono::high_resolution_clock::now();
+    DistanceTable table = many_to_many(ch, origins, destinations, threads);
+    auto end_time = chrono::high_resolution_clock::now();
+    auto duration =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    cout << "CH Table Time: " << duration.count() / 1000.0 << " ms ("
+         << table.rows << " x " << table.cols << ")" << endl;
+
+    if (matrix_out) {
+        if (!write_matrix(matrix_out, table)) {
+            cerr << "Cannot write matrix to " << matrix_out << endl;
+            return 1;
+        }
+    } else if (!quiet) {
+        cout << "--------------------" << endl;
+        for (int i = 0; i < table.rows; ++i)
+            for (int j = 0; j < table.cols; ++j)
+                print_distance(origins[i], destinations[j], table.at(i, j));
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    bool quiet = false;
+    bool binary = false;
+    const char* save_path = nullptr;
+    const char* load_path = nullptr;
+    const char* snapshot_path = nullptr;
+    const char* query_path = nullptr;
+    const char* origin_path = nullptr;
+    const char* dest_path = nullptr;
+    const char* matrix_out = nullptr;
+    int threads = 0;
+    NumaMode numa = NUMA_DEFAULT;
+    bool pin_threads = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--binary") == 0)
+            binary = true;
+        else if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+            save_path = argv[++i];
+        else if (strcmp(argv[i], "--load") == 0 && i + 1 < argc)
+            load_path = argv[++i];
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+            snapshot_path = argv[++i];
+        else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc)
+            query_path = argv[++i];
+        else if (strcmp(argv[i], "--origins") == 0 && i + 1 < argc)
+            origin_path = argv[++i];
+        else if (strcmp(argv[i], "--destinations") == 0 && i + 1 < argc)
+            dest_path = argv[++i];
+        else if (strcmp(argv[i], "--matrix-out") == 0 && i + 1 < argc)
+            matrix_out = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--numa") == 0 && i + 1 < argc) {
+            if (!parse_numa_mode(argv[++i], numa)) {
+                cerr << "Unknown NUMA mode: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--pin-threads") == 0)
+            pin_threads = true;
+    }
+
+    // The placement policy covers the graph and the hierarchy; per-thread
+    // query state allocated later falls back to first touch.
+    bool numa_applied = numa == NUMA_DEFAULT || set_numa_mode(numa);
+    set_thread_pinning(pin_threads);
+
+    ContractionHierarchy ch;
+    if (load_path) {
+        if (!read_ch(load_path, ch)) {
+            cerr << "Cannot read hierarchy from " << load_path << endl;
+            return 1;
+        }
+    } else {
+        GraphInput g;
+        if (snapshot_path) {
+            MappedSnapshot snapshot;
+            string error;
+            if (!snapshot.open(snapshot_path, error) ||
+                !load_snapshot_graph(snapshot, false, g, error)) {
+                cerr << "Cannot load snapshot: " << error << endl;
+                return 1;
+            }
+        } else {
+            LoadStatus status = load_graph(binary, false, g);
+            if (status == LOAD_EMPTY)
+                return 0;
+            if (status != LOAD_OK) {
+                report_load_error(status, g);
+                return 1;
+            }
+        }
+
+        auto start_time = chrono::high_resolution_clock::now();
+        ch = build_ch(g.n, g.adj);
+        auto end_time = chrono::high_resolution_clock::now();
+        auto duration =
+            chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        cout << "CH Preprocessing Time: " << duration.count() / 1000.0
+             << " ms (" << ch.shortcuts << " shortcuts)" << endl;
+    }
+
+    if (numa != NUMA_DEFAULT && numa_applied)
+        set_numa_mode(NUMA_DEFAULT);
+    if (numa != NUMA_DEFAULT || pin_threads)
+        cout << describe_placement(numa, numa_applied, pin_threads) << endl;
+
+    if (save_path && !write_ch(save_path, ch)) {
+        cerr << "Cannot write hierarchy to " << save_path << endl;
+        return 1;
+    }
+
+    if (origin_path && dest_path)
+        return run_table(ch, origin_path, dest_path, matrix_out, threads,
+                         quiet);
+
+    if (!query_path)
+        return 0;
+
+    // Each query line is `source target [target ...]`; several targets
+    // make it a one-to-many query sharing the forward search.
+    ifstream in(query_path);
+    if (!in) {
+        cerr << "Cannot open query file: " << query_path << endl;
+        return 1;
+    }
+    vector<pair<vertex_t, vector<vertex_t>>> queries;
+    string line;
+    int query_id = 0;
+    while (getline(in, line)) {
+        istringstream ls(line);
+        if ((ls >> ws).eof())
+            continue; // blank line
+        int id = query_id++;
+        vertex_t s, t;
+        vector<vertex_t> targets;
+        bool ok = static_cast<bool>(ls >> s >> t);
+        while (ok) {
+            targets.push_back(t);
+            ok = static_cast<bool>(ls >> t);
+        }
+        // Every token must have been read as a node id.
+        if (targets.empty() || !ls.eof()) {
+            cerr << "Query " << id << ": malformed line \"" << line
+                 << "\"" << endl;
+            continue;
+        }
+        bool valid = s >= 0 && s < ch.n;
+        for (vertex_t x : targets)
+            valid = valid && x >= 0 && x < ch.n;
+        if (!valid) {
+            cerr << "Query node out of range: " << line << endl;
+            return 1;
+        }
+        queries.push_back({s, targets});
+    }
+
+    // Queries are independent: each worker answers a share of them with
+    // its own search state.
+    if (threads <= 0)
+        threads = default_thread_count();
+    vector<unique_ptr<ChQuery>> workers(threads);
+    vector<long long> worker_settled(threads, 0);
+    vector<vector<double>> results(queries.size());
+    auto start_time = chrono::high_resolution_clock::now();
+    parallel_for((int)queries.size(), threads, [&](int w, int i) {
+        if (!workers[w])
+            workers[w].reset(new ChQuery(ch));
+        ChQuery& query = *workers[w];
+        const auto& q = queries[i];
+        if (q.second.size() == 1)
+            results[i] = {query.distance(q.first, q.second[0])};
+        else
+            results[i] = query.one_to_many(q.first, q.second);
+        worker_settled[w] += query.settled;
+    }, 16);
+    long long settled = 0;
+    for (long long s : worker_settled)
+        settled += s;
+    auto end_time = chrono::high_resolution_clock::now();
+    auto duration =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    cout << "CH Query Time: " << duration.count() / 1000.0 << " ms ("
+         << queries.size() << " queries, " << settled << " settled)" << endl;
+
+    if (!quiet) {
+        cout << "--------------------" << endl;
+        for (size_t i = 0; i < queries.size(); ++i)
+            for (size_t j = 0; j < queries[i].second.size(); ++j)
+                print_distance(queries[i].first, queries[i].second[j],
+                               results[i][j]);
+    }
+    return 0;
+}
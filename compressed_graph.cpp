@@ -0,0 +1,92 @@
+#include "compressed_graph.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+static void write_varint(vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back((uint8_t)value);
+}
+
+// Smallest power of two 2^-k, k <= 16, of which every weight is a multiple,
+// or 0 when there is none.
+static double exact_resolution(const vector<vector<Edge>>& adj) {
+    int k = 0;
+    for (const auto& row : adj)
+        for (const auto& e : row)
+            while (ldexp(e.weight, k) != floor(ldexp(e.weight, k)))
+                if (++k > 16)
+                    return 0;
+    return ldexp(1.0, -k);
+}
+
+static double pick_resolution(const vector<vector<Edge>>& adj) {
+    double max_weight = 0, min_weight = 0;
+    for (const auto& row : adj)
+        for (const auto& e : row) {
+            max_weight = max(max_weight, e.weight);
+            if (e.weight > 0 && (min_weight == 0 || e.weight < min_weight))
+                min_weight = e.weight;
+        }
+    if (max_weight == 0)
+        return 1;
+    double exact = exact_resolution(adj);
+    if (exact > 0 && max_weight / exact <= ldexp(1.0, 53))
+        return exact;
+    // Rounding moves a weight by at most half a step, and the step is a
+    // RELATIVE_BITS-bit fraction of the smallest weight. Quantized values
+    // stay below 2^53 so they convert back exactly.
+    return max(ldexp(min_weight, -RELATIVE_BITS), ldexp(max_weight, -53));
+}
+
+CompressedGraph compress_graph(vertex_t n, const vector<vector<Edge>>& adj,
+                               double resolution) {
+    CompressedGraph g;
+    g.n = n;
+    g.scale = resolution > 0 ? resolution : pick_resolution(adj);
+    g.anchors.resize((n + ROW_GROUP - 1) / ROW_GROUP);
+    g.offsets.resize(n);
+
+    vector<uint8_t> bytes;
+    vector<Edge> row;
+    for (vertex_t u = 0; u < n; ++u) {
+        edge_t pos = (edge_t)bytes.size();
+        if (u % ROW_GROUP == 0)
+            g.anchors[u / ROW_GROUP] = pos;
+        edge_t relative = pos - g.anchors[u / ROW_GROUP];
+        if (relative > (edge_t)UINT32_MAX)
+            throw length_error("compressed row group exceeds 4 GB");
+        g.offsets[u] = (uint32_t)relative;
+        row.assign(adj[u].begin(), adj[u].end());
+        sort(row.begin(), row.end(), [](const Edge& a, const Edge& b) {
+            return a.to < b.to;
+        });
+        write_varint(bytes, row.size());
+        vertex_t prev = u;
+        for (size_t i = 0; i < row.size(); ++i) {
+            int64_t delta = (int64_t)row[i].to - prev;
+            uint64_t gap = (uint64_t)delta;
+            if (i == 0) // zigzag: the first target may lie below u
+                gap = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+            write_varint(bytes, gap);
+            uint64_t q = (uint64_t)llround(row[i].weight / g.scale);
+            if (q == 0 && row[i].weight > 0)
+                q = 1;
+            write_varint(bytes, q);
+            if (row[i].weight > 0)
+                g.max_relative_error =
+                    max(g.max_relative_error,
+                        fabs((double)q * g.scale - row[i].weight) /
+                            row[i].weight);
+            prev = row[i].to;
+        }
+        g.m += (edge_t)row.size();
+    }
+    g.data.assign(bytes.begin(), bytes.end());
+    return g;
+}
@@ -0,0 +1,215 @@
+#include "csr_file.h"
+#include "graph_io.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Byte offsets of the three arrays for a graph of n nodes and m edges.
+struct CsrFileLayout {
+    size_t offsets, targets, weights, total;
+
+    CsrFileLayout(int64_t n, int64_t m) {
+        offsets = sizeof(CsrFileHeader);
+        targets = offsets + (size_t)(n + 1) * sizeof(edge_t);
+        weights = targets + (size_t)m * sizeof(vertex_t);
+        weights = (weights + 7) / 8 * 8;
+        total = weights + (size_t)m * sizeof(double);
+    }
+};
+
+static CsrFileHeader make_header(int64_t n, int64_t m) {
+    CsrFileHeader h;
+    memcpy(h.magic, CSR_FILE_MAGIC, 4);
+    h.version = CSR_FILE_VERSION;
+    h.n = n;
+    h.m = m;
+    return h;
+}
+
+bool write_csr_file(const string& path, const CsrView& graph) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    int64_t m = graph.edge_count();
+    CsrFileLayout layout(graph.n, m);
+    CsrFileHeader header = make_header(graph.n, m);
+    static const char zeros[8] = {0};
+    size_t pad = layout.weights - (layout.targets + m * sizeof(vertex_t));
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(graph.offsets, sizeof(edge_t), graph.n + 1, f) ==
+                  (size_t)graph.n + 1 &&
+              fwrite(graph.targets, sizeof(vertex_t), m, f) == (size_t)m &&
+              fwrite(zeros, 1, pad, f) == pad &&
+              fwrite(graph.weights, sizeof(double), m, f) == (size_t)m;
+    return fclose(f) == 0 && ok;
+}
+
+// Reads the binary edge records of `in` in chunks, calling visit(edge) for
+// every in-range edge. Returns false if the file is truncated.
+template <class Visit>
+static bool scan_edges(FILE* in, const BinaryHeader& header, Visit visit) {
+    if (fseek(in, sizeof(BinaryHeader), SEEK_SET) != 0)
+        return false;
+    vector<BinaryEdge> chunk(1 << 16);
+    for (edge_t done = 0; done < (edge_t)header.m;) {
+        size_t count =
+            (size_t)min<edge_t>((edge_t)header.m - done, chunk.size());
+        if (fread(chunk.data(), sizeof(BinaryEdge), count, in) != count)
+            return false;
+        for (size_t i = 0; i < count; ++i) {
+            const BinaryEdge& e = chunk[i];
+            if (e.u >= 0 && e.u < header.n && e.v >= 0 && e.v < header.n)
+                visit(e);
+        }
+        done += count;
+    }
+    return true;
+}
+
+bool convert_to_csr_file(const string& binary_path, const string& out_path,
+                         vertex_t& source, string& error) {
+    FILE* in = fopen(binary_path.c_str(), "rb");
+    if (!in) {
+        error = "cannot open " + binary_path;
+        return false;
+    }
+    BinaryHeader header;
+    if (fread(&header, sizeof(header), 1, in) != 1 || header.n < 0) {
+        fclose(in);
+        error = "bad graph header";
+        return false;
+    }
+    source = header.source;
+
+    vector<edge_t> offsets(header.n + 1, 0);
+    bool negative = false;
+    if (!scan_edges(in, header, [&](const BinaryEdge& e) {
+            offsets[e.u + 1]++;
+            negative |= !(e.w >= 0);
+        })) {
+        fclose(in);
+        error = "truncated edge list";
+        return false;
+    }
+    if (negative) {
+        fclose(in);
+        error = "negative edge weight";
+        return false;
+    }
+    for (int64_t u = 0; u < header.n; ++u)
+        offsets[u + 1] += offsets[u];
+    int64_t m = offsets[header.n];
+    CsrFileLayout layout(header.n, m);
+
+    int fd = ::open(out_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, layout.total) != 0) {
+        if (fd >= 0)
+            ::close(fd);
+        fclose(in);
+        error = "cannot create " + out_path;
+        return false;
+    }
+    void* map = mmap(nullptr, layout.total, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        fclose(in);
+        error = "cannot map " + out_path;
+        return false;
+    }
+
+    char* base = (char*)map;
+    CsrFileHeader out_header = make_header(header.n, m);
+    memcpy(base, &out_header, sizeof(out_header));
+    memcpy(base + layout.offsets, offsets.data(),
+           offsets.size() * sizeof(edge_t));
+    vertex_t* targets = (vertex_t*)(base + layout.targets);
+    double* weights = (double*)(base + layout.weights);
+
+    // Scatter pass: offsets becomes the fill cursor of each row.
+    offsets.pop_back();
+    bool ok = scan_edges(in, header, [&](const BinaryEdge& e) {
+        edge_t pos = offsets[e.u]++;
+        targets[pos] = e.v;
+        weights[pos] = e.w;
+    });
+    fclose(in);
+    ok = msync(map, layout.total, MS_SYNC) == 0 && ok;
+    munmap(map, layout.total);
+    if (!ok)
+        error = "write failed";
+    return ok;
+}
+
+MappedCsr::~MappedCsr() {
+    close();
+}
+
+bool MappedCsr::open(const string& path, string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CsrFileHeader)) {
+        ::close(fd);
+        error = "file too small";
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    base = map;
+    length = st.st_size;
+
+    CsrFileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (memcmp(header.magic, CSR_FILE_MAGIC, 4) != 0) {
+        error = "not a CSR file";
+    } else if (header.version != CSR_FILE_VERSION) {
+        error = "unsupported CSR file version";
+    } else if (header.n < 0 || header.n > numeric_limits<vertex_t>::max()) {
+        error = "CSR node count out of range";
+    } else if (header.m < 0 ||
+               header.m > (int64_t)(length / (sizeof(vertex_t) +
+                                              sizeof(double))) ||
+               CsrFileLayout(header.n, header.m).total > length) {
+        // The edge count is bounded by the file size first, so computing
+        // the layout cannot overflow.
+        error = "truncated CSR file";
+    } else {
+        CsrFileLayout layout(header.n, header.m);
+        const char* bytes = (const char*)base;
+        view.n = (vertex_t)header.n;
+        view.offsets = (const edge_t*)(bytes + layout.offsets);
+        view.targets = (const vertex_t*)(bytes + layout.targets);
+        view.weights = (const double*)(bytes + layout.weights);
+        if (view.offsets[view.n] == header.m && valid_csr(view))
+            return true;
+        error = "corrupt CSR arrays";
+    }
+    close();
+    return false;
+}
+
+void MappedCsr::close() {
+    if (base)
+        munmap((void*)base, length);
+    base = nullptr;
+    length = 0;
+    view = CsrView();
+}
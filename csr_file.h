@@ -0,0 +1,55 @@
+#ifndef CSR_FILE_H
+#define CSR_FILE_H
+
+#include "csr_graph.h"
+#include "types.h"
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// On-disk CSR graph, laid out so that it can be memory-mapped and used in
+// place: header, offsets[n + 1] (int64), targets[m] (int32), padding to 8
+// bytes, weights[m] (float64). All values are little-endian.
+const char CSR_FILE_MAGIC[4] = {'B', 'M', 'C', 'S'};
+const uint32_t CSR_FILE_VERSION = 1;
+
+struct CsrFileHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t n;
+    int64_t m;
+};
+
+// Writes an in-memory CSR graph. Returns false on I/O error.
+bool write_csr_file(const string& path, const CsrView& graph);
+
+// Builds a CSR file from a graph in the binary input format without holding
+// the edges in memory: one pass counts degrees, a second pass scatters the
+// edges into the mapped output file. Out-of-range edges are dropped; a
+// negative (or NaN) weight fails the conversion before the output exists.
+// `source` receives the source stored in the input header.
+bool convert_to_csr_file(const string& binary_path, const string& out_path,
+                         vertex_t& source, string& error);
+
+// Read-only memory mapping of a CSR file. open() checks the header against
+// the file size and then the arrays with valid_csr, which reads the file
+// once; later pages are read again on access. The view stays valid while
+// the mapping is open.
+struct MappedCsr {
+    CsrView view;
+
+    MappedCsr() = default;
+    MappedCsr(const MappedCsr&) = delete;
+    MappedCsr& operator=(const MappedCsr&) = delete;
+    ~MappedCsr();
+
+    bool open(const string& path, string& error);
+    void close();
+
+    // The whole mapping, header included.
+    const void* base = nullptr;
+    size_t length = 0;
+};
+
+#endif // CSR_FILE_H
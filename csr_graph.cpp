@@ -0,0 +1,161 @@
+#include "csr_graph.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+CsrGraph build_csr(vertex_t n, const vector<vector<Edge>>& adj) {
+    CsrGraph g;
+    g.n = n;
+    g.offsets.resize(n + 1);
+    g.offsets[0] = 0;
+    for (vertex_t u = 0; u < n; ++u)
+        g.offsets[u + 1] = g.offsets[u] + (edge_t)adj[u].size();
+    g.targets.resize(g.offsets[n]);
+    g.weights.resize(g.offsets[n]);
+    for (vertex_t u = 0; u < n; ++u) {
+        edge_t pos = g.offsets[u];
+        for (const auto& e : adj[u]) {
+            g.targets[pos] = e.to;
+            g.weights[pos] = e.weight;
+            pos++;
+        }
+    }
+    return g;
+}
+
+vector<vector<Edge>> csr_to_adjacency(const CsrView& graph) {
+    vector<vector<Edge>> adj(graph.n);
+    for (vertex_t u = 0; u < graph.n; ++u) {
+        CsrRow row = graph[u];
+        adj[u].reserve(row.size());
+        for (const auto& e : row)
+            adj[u].push_back(e);
+    }
+    return adj;
+}
+
+bool valid_csr(const CsrView& graph) {
+    if (graph.n < 0 || !graph.offsets || graph.offsets[0] != 0)
+        return false;
+    for (vertex_t u = 0; u < graph.n; ++u)
+        if (graph.offsets[u + 1] < graph.offsets[u])
+            return false;
+    edge_t m = graph.offsets[graph.n];
+    if (m > 0 && (!graph.targets || !graph.weights))
+        return false;
+    for (edge_t i = 0; i < m; ++i)
+        if (graph.targets[i] < 0 || graph.targets[i] >= graph.n ||
+            !(graph.weights[i] >= 0))
+            return false;
+    return true;
+}
+
+// Rows are handed to workers in blocks of this many nodes.
+static const int ROW_BLOCK = 4096;
+
+// Below this many edges per chunk the histograms cost more than they save.
+static const size_t MIN_CHUNK_EDGES = 1 << 16;
+
+static int row_block_count(vertex_t n) {
+    return (int)(((int64_t)n + ROW_BLOCK - 1) / ROW_BLOCK);
+}
+
+static vertex_t row_block_end(vertex_t n, int b) {
+    return (vertex_t)min<int64_t>(n, ((int64_t)b + 1) * ROW_BLOCK);
+}
+
+// Counts each chunk's edges per row, turns the counts into the chunk's
+// offsets inside the rows and scatters the edges. Count only has to hold a
+// row's degree, so 32-bit counters halve the histograms when m fits.
+template <class Count>
+static void scatter_edges(CsrGraph& g, const vector<BinaryEdge>& edges,
+                          int chunks, int threads) {
+    vertex_t n = g.n;
+    size_t m = edges.size();
+    int row_blocks = row_block_count(n);
+    auto chunk_begin = [&](int c) { return m * c / chunks; };
+
+    // Degree histogram of every chunk.
+    vector<vector<Count>> cursor(chunks);
+    parallel_for(chunks, chunks, [&](int, int c) {
+        cursor[c].assign(n, 0);
+        for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i)
+            cursor[c][edges[i].u]++;
+    });
+
+    // Row sizes, turning each histogram entry into the chunk's offset inside
+    // the row, then the prefix sum over rows.
+    g.offsets.resize((size_t)n + 1);
+    g.offsets[0] = 0;
+    parallel_for(row_blocks, threads, [&](int, int b) {
+        for (vertex_t u = b * ROW_BLOCK; u < row_block_end(n, b); ++u) {
+            Count total = 0;
+            for (int c = 0; c < chunks; ++c) {
+                Count count = cursor[c][u];
+                cursor[c][u] = total;
+                total += count;
+            }
+            g.offsets[u + 1] = total;
+        }
+    });
+    for (vertex_t u = 0; u < n; ++u)
+        g.offsets[u + 1] += g.offsets[u];
+
+    g.targets.resize(m);
+    g.weights.resize(m);
+    parallel_for(chunks, chunks, [&](int, int c) {
+        vector<Count>& next = cursor[c];
+        for (size_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+            const BinaryEdge& e = edges[i];
+            edge_t pos = g.offsets[e.u] + next[e.u]++;
+            g.targets[pos] = e.v;
+            g.weights[pos] = e.w;
+        }
+        vector<Count>().swap(next);
+    });
+}
+
+CsrGraph build_csr(vertex_t n, const vector<BinaryEdge>& edges, int threads,
+                   bool sort_rows) {
+    if (threads <= 0)
+        threads = default_thread_count();
+    size_t m = edges.size();
+    // One histogram of n counters per chunk; keep them all within the size
+    // of the edge list (16 bytes per edge, 4 per 32-bit counter).
+    size_t max_chunks = min<size_t>((size_t)threads, m / MIN_CHUNK_EDGES);
+    if (n > 0)
+        max_chunks = min<size_t>(max_chunks, 4 * m / (size_t)n);
+    int chunks = (int)max<size_t>(1, max_chunks);
+    int row_blocks = row_block_count(n);
+
+    CsrGraph g;
+    g.n = n;
+    if (m <= numeric_limits<uint32_t>::max())
+        scatter_edges<uint32_t>(g, edges, chunks, threads);
+    else
+        scatter_edges<edge_t>(g, edges, chunks, threads);
+
+    if (sort_rows) {
+        parallel_for(row_blocks, threads, [&](int, int b) {
+            vector<pair<vertex_t, double>> row;
+            for (vertex_t u = b * ROW_BLOCK; u < row_block_end(n, b); ++u) {
+                edge_t begin = g.offsets[u], end = g.offsets[u + 1];
+                if (end - begin < 2)
+                    continue;
+                row.clear();
+                for (edge_t i = begin; i < end; ++i)
+                    row.push_back({g.targets[i], g.weights[i]});
+                sort(row.begin(), row.end());
+                for (edge_t i = begin; i < end; ++i) {
+                    g.targets[i] = row[i - begin].first;
+                    g.weights[i] = row[i - begin].second;
+                }
+            }
+        });
+    }
+    return g;
+}
@@ -0,0 +1,95 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph_io.h"
+#include "huge_pages.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// Outgoing edges of one node in a CSR graph. Iteration yields Edge values,
+// so solver loops written against vector<Edge> rows work unchanged.
+struct CsrRow {
+    const vertex_t* to;
+    const double* weight;
+    size_t count;
+
+    struct iterator {
+        const vertex_t* to;
+        const double* weight;
+
+        Edge operator*() const { return {*to, *weight}; }
+        iterator& operator++() {
+            ++to;
+            ++weight;
+            return *this;
+        }
+        bool operator!=(const iterator& other) const { return to != other.to; }
+    };
+
+    Edge operator[](size_t i) const { return {to[i], weight[i]}; }
+    iterator begin() const { return {to, weight}; }
+    iterator end() const { return {to + count, weight + count}; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+// Non-owning view of a CSR graph: edges of node u are at positions
+// [offsets[u], offsets[u + 1]) of `targets` and `weights`.
+struct CsrView {
+    vertex_t n = 0;
+    const edge_t* offsets = nullptr;
+    const vertex_t* targets = nullptr;
+    const double* weights = nullptr;
+
+    CsrRow operator[](vertex_t u) const {
+        edge_t begin = offsets[u];
+        return {targets + begin, weights + begin,
+                (size_t)(offsets[u + 1] - begin)};
+    }
+    size_t size() const { return (size_t)n; }
+    edge_t edge_count() const { return n == 0 ? 0 : offsets[n]; }
+};
+
+// Owning CSR graph in three flat arrays, allocated through the huge page
+// policy (see huge_pages.h).
+struct CsrGraph {
+    vertex_t n = 0;
+    HugeVector<edge_t> offsets;
+    HugeVector<vertex_t> targets;
+    HugeVector<double> weights;
+
+    CsrView view() const {
+        return {n, offsets.data(), targets.data(), weights.data()};
+    }
+    size_t bytes() const {
+        return offsets.size() * sizeof(edge_t) +
+               targets.size() * sizeof(vertex_t) +
+               weights.size() * sizeof(double);
+    }
+};
+
+// Copies adjacency lists into CSR form, keeping the edge order of each row.
+CsrGraph build_csr(vertex_t n, const vector<vector<Edge>>& adj);
+
+// Copies a CSR graph back into adjacency lists, keeping the row order.
+vector<vector<Edge>> csr_to_adjacency(const CsrView& graph);
+
+// Checks arrays handed in from outside: offsets start at 0 and never
+// decrease, targets lie in [0, n) and weights are non-negative.
+bool valid_csr(const CsrView& graph);
+
+// Builds CSR arrays straight from an edge list (endpoints in [0, n)) on
+// `threads` workers (0 = all hardware threads). The list is cut into one
+// chunk per worker: each chunk counts its row degrees into its own
+// histogram, a prefix sum over rows and chunks gives every chunk a write
+// cursor per row, and the chunks scatter their edges in parallel. Rows keep
+// the edge order of the list, as with adjacency lists, unless `sort_rows`
+// sorts each row by target (then weight) for locality.
+CsrGraph build_csr(vertex_t n, const vector<BinaryEdge>& edges, int threads,
+                   bool sort_rows = false);
+
+#endif // CSR_GRAPH_H
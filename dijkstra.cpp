@@ -1,67 +1,14 @@
-#include "types.h"
-#include <chrono>
-#include <cstdio>
-#include <cstring>
-#include <iostream>
+#include "dijkstra.h"
+#include <algorithm>
 #include <limits>
 #include <queue>
-#include <vector>
 
 using namespace std;
 
-int main(int argc, char* argv[]) {
-    ios::sync_with_stdio(false);
-    cin.tie(nullptr);
-
-    bool quiet = false;
-    bool binary = false;
-    for (int i = 1; i < argc; ++i) {
-        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
-            quiet = true;
-        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--binary") == 0)
-            binary = true;
-    }
-
-    int n, m, source;
-    vector<vector<Edge>> adj;
-
-    if (binary) {
-        int32_t header[3];
-        if (fread(header, sizeof(int32_t), 3, stdin) != 3)
-            return 0;
-        n = header[0];
-        m = header[1];
-        source = header[2];
-        adj.resize(n);
-
-        struct BinaryEdge {
-            int32_t u, v;
-            double w;
-        };
-        vector<BinaryEdge> edges(m);
-        if (fread(edges.data(), sizeof(BinaryEdge), m, stdin) != (size_t)m)
-            return 1;
-        for (int i = 0; i < m; ++i) {
-            if (edges[i].u < n && edges[i].v < n)
-                adj[edges[i].u].push_back({edges[i].v, edges[i].w});
-        }
-    } else {
-        if (!(cin >> n >> m))
-            return 0;
-        adj.resize(n);
-        for (int i = 0; i < m; ++i) {
-            int u, v;
-            double w;
-            cin >> u >> v >> w;
-            if (u < n && v < n)
-                adj[u].push_back({v, w});
-        }
-        cin >> source;
-    }
+namespace {
 
-    auto start_time = chrono::high_resolution_clock::now();
-
-    // Standard Dijkstra using min-heap
+template <class Graph>
+vector<double> dijkstra_rows(vertex_t n, const Graph& adj, vertex_t source) {
     vector<double> dist(n, numeric_limits<double>::infinity());
     priority_queue<State, vector<State>, greater<State>> pq;
     dist[source] = 0.0;
@@ -82,24 +29,102 @@ int main(int argc, char* argv[]) {
             }
         }
     }
+    return dist;
+}
 
-    auto end_time = chrono::high_resolution_clock::now();
-
-    auto duration =
-        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
-    cout << "Dijkstra Time: " << duration.count() / 1000.0 << " ms" << endl;
-
-    if (!quiet) {
-        cout << "--------------------" << endl;
-        for (int i = 0; i < n; ++i) {
-            cout << "Node " << i << ": ";
-            if (dist[i] == numeric_limits<double>::infinity())
-                cout << "INF";
-            else
-                cout << dist[i];
-            cout << endl;
+} // namespace
+
+vector<double> dijkstra(vertex_t n, const vector<vector<Edge>>& adj,
+                        vertex_t source) {
+    return dijkstra_rows(n, adj, source);
+}
+
+vector<double> dijkstra(const CsrView& graph, vertex_t source) {
+    return dijkstra_rows(graph.n, graph, source);
+}
+
+double astar(vertex_t n, const vector<vector<Edge>>& adj, vertex_t source,
+             vertex_t target, const Landmarks& lm, long long* settled) {
+    const double INF = numeric_limits<double>::infinity();
+    vector<double> dist(n, INF);
+    // Lower bounds are evaluated once per node, on first touch.
+    vector<double> h(n, -1.0);
+    auto heuristic = [&](int v) {
+        if (h[v] < 0)
+            h[v] = lm.lower_bound(v, target);
+        return h[v];
+    };
+
+    // Heap keys are d(v) + h(v); State::cost holds the key.
+    priority_queue<State, vector<State>, greater<State>> pq;
+    long long count = 0;
+    dist[source] = 0.0;
+    if (heuristic(source) != INF)
+        pq.push({source, heuristic(source)});
+
+    while (!pq.empty()) {
+        State cur = pq.top();
+        pq.pop();
+        int u = cur.node_id;
+        if (cur.cost > dist[u] + h[u])
+            continue;
+        count++;
+        if (u == target)
+            break;
+
+        for (const Edge& e : adj[u]) {
+            double new_dist = dist[u] + e.weight;
+            if (new_dist < dist[e.to]) {
+                double hv = heuristic(e.to);
+                if (hv == INF)
+                    continue;
+                dist[e.to] = new_dist;
+                pq.push({e.to, new_dist + hv});
+            }
         }
     }
+    if (settled)
+        *settled = count;
+    return dist[target];
+}
 
-    return 0;
+double bidirectional_dijkstra(vertex_t n, const vector<vector<Edge>>& adj,
+                              const vector<vector<Edge>>& radj,
+                              vertex_t source, vertex_t target,
+                              long long* settled) {
+    const double INF = numeric_limits<double>::infinity();
+    const vector<vector<Edge>>* graph[2] = {&adj, &radj};
+    vector<double> dist[2] = {vector<double>(n, INF), vector<double>(n, INF)};
+    priority_queue<State, vector<State>, greater<State>> pq[2];
+    long long count = 0;
+
+    dist[0][source] = 0.0;
+    dist[1][target] = 0.0;
+    pq[0].push({source, 0.0});
+    pq[1].push({target, 0.0});
+    double best = source == target ? 0.0 : INF;
+
+    while (!pq[0].empty() && !pq[1].empty()) {
+        // Meeting criterion: no path shorter than best can still be found.
+        if (pq[0].top().cost + pq[1].top().cost >= best)
+            break;
+        int side = pq[0].top().cost <= pq[1].top().cost ? 0 : 1;
+        State cur = pq[side].top();
+        pq[side].pop();
+        if (cur.cost > dist[side][cur.node_id])
+            continue;
+        count++;
+
+        for (const Edge& e : (*graph[side])[cur.node_id]) {
+            double new_dist = cur.cost + e.weight;
+            if (new_dist < dist[side][e.to]) {
+                dist[side][e.to] = new_dist;
+                pq[side].push({e.to, new_dist});
+            }
+            best = min(best, new_dist + dist[1 - side][e.to]);
+        }
+    }
+    if (settled)
+        *settled = count;
+    return best;
 }
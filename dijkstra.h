@@ -0,0 +1,30 @@
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+#include "csr_graph.h"
+#include "landmarks.h"
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Standard Dijkstra using a binary min-heap.
+vector<double> dijkstra(vertex_t n, const vector<vector<Edge>>& adj,
+                        vertex_t source);
+vector<double> dijkstra(const CsrView& graph, vertex_t source);
+
+// Goal-directed point-to-point query: A* with ALT landmark lower bounds.
+// Returns d(source, target); `settled` receives the number of settled nodes.
+double astar(vertex_t n, const vector<vector<Edge>>& adj, vertex_t source,
+             vertex_t target, const Landmarks& lm,
+             long long* settled = nullptr);
+
+// Bidirectional point-to-point Dijkstra. radj is the transpose of adj. The
+// forward and backward searches alternate by smaller queue key and stop once
+// the two keys together reach the best meeting distance.
+double bidirectional_dijkstra(vertex_t n, const vector<vector<Edge>>& adj,
+                              const vector<vector<Edge>>& radj,
+                              vertex_t source, vertex_t target,
+                              long long* settled = nullptr);
+
+#endif // DIJKSTRA_H
@@ -0,0 +1,169 @@
+#include "dijkstra.h"
+#include "graph_io.h"
+#include "landmarks.h"
+#include "snapshot.h"
+#include "turn_graph.h"
+#include "types.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    bool quiet = false;
+    bool binary = false;
+    vertex_t target = -1;
+    int landmark_count = 0;
+    bool bidir = false;
+    bool reverse = false;
+    const char* turns_path = nullptr;
+    double u_turn_penalty = 0;
+    const char* snapshot_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--binary") == 0)
+            binary = true;
+        else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc)
+            target = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--landmarks") == 0 && i + 1 < argc)
+            landmark_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bidir") == 0)
+            bidir = true;
+        else if (strcmp(argv[i], "--reverse") == 0)
+            reverse = true;
+        else if (strcmp(argv[i], "--turns") == 0 && i + 1 < argc)
+            turns_path = argv[++i];
+        else if (strcmp(argv[i], "--u-turn-penalty") == 0 && i + 1 < argc)
+            u_turn_penalty = atof(argv[++i]);
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+            snapshot_path = argv[++i];
+    }
+
+    bool with_reverse =
+        reverse || (target >= 0 && (bidir || landmark_count > 0));
+    GraphInput g;
+    MappedSnapshot snapshot;
+    if (snapshot_path) {
+        string error;
+        if (!snapshot.open(snapshot_path, error) ||
+            !load_snapshot_graph(snapshot, with_reverse, g, error)) {
+            cerr << "Cannot load snapshot: " << error << endl;
+            return 1;
+        }
+    } else {
+        LoadStatus status = load_graph(binary, with_reverse, g);
+        if (status == LOAD_EMPTY)
+            return 0;
+        if (status != LOAD_OK) {
+            report_load_error(status, g);
+            return 1;
+        }
+    }
+    vertex_t n = g.n;
+    vertex_t source = g.source;
+
+    // Reverse mode answers every query on the transposed graph.
+    const vector<vector<Edge>>& adj = reverse ? g.radj : g.adj;
+    const vector<vector<Edge>>& radj = reverse ? g.adj : g.radj;
+
+    if (target >= n) {
+        cerr << "Target out of range" << endl;
+        return 1;
+    }
+    if (turns_path && (target >= 0 || reverse)) {
+        cerr << "--turns only supports single-source solves" << endl;
+        return 1;
+    }
+
+    // Point-to-point query: bidirectional, or goal-directed when landmarks
+    // are requested
+    if (target >= 0) {
+        Landmarks landmarks;
+        if (landmark_count > 0 && !bidir && !reverse && snapshot_path &&
+            snapshot.landmarks(landmarks)) {
+            cout << "Landmarks: " << landmarks.ids.size() << " from snapshot"
+                 << endl;
+        } else if (landmark_count > 0 && !bidir) {
+            auto pre_start = chrono::high_resolution_clock::now();
+            landmarks = select_landmarks(n, adj, radj, landmark_count);
+            auto pre_end = chrono::high_resolution_clock::now();
+            auto pre = chrono::duration_cast<chrono::microseconds>(
+                pre_end - pre_start);
+            cout << "Preprocessing Time: " << pre.count() / 1000.0 << " ms ("
+                 << landmarks.ids.size() << " landmarks)" << endl;
+        }
+
+        long long settled = 0;
+        auto start_time = chrono::high_resolution_clock::now();
+        double d = bidir ? bidirectional_dijkstra(n, adj, radj, source,
+                                                  target, &settled)
+                         : astar(n, adj, source, target, landmarks, &settled);
+        auto end_time = chrono::high_resolution_clock::now();
+        auto duration =
+            chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        cout << "Dijkstra Time: " << duration.count() / 1000.0 << " ms ("
+             << settled << " settled)" << endl;
+        if (!quiet) {
+            cout << "Node " << target << ": ";
+            if (d == numeric_limits<double>::infinity())
+                cout << "INF";
+            else
+                cout << d;
+            cout << endl;
+        }
+        return 0;
+    }
+
+    // Turn-restricted mode: solve on the edge-based expansion
+    EdgeBasedGraph eg;
+    if (turns_path) {
+        vector<TurnCost> turns;
+        if (!read_turn_costs(turns_path, turns)) {
+            cerr << "Cannot read turn costs from " << turns_path << endl;
+            return 1;
+        }
+        try {
+            eg = build_edge_based(n, adj, turns, u_turn_penalty);
+        } catch (const overflow_error& e) {
+            cerr << "Cannot expand graph for turn costs: " << e.what()
+                 << endl;
+            return 1;
+        }
+    }
+
+    auto start_time = chrono::high_resolution_clock::now();
+    vector<double> dist =
+        turns_path ? vertex_distances(eg, source,
+                                      dijkstra(eg.graph.view(),
+                                               eg.entry_node(source)))
+                   : dijkstra(n, adj, source);
+    auto end_time = chrono::high_resolution_clock::now();
+
+    auto duration =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    cout << "Dijkstra Time: " << duration.count() / 1000.0 << " ms" << endl;
+
+    if (!quiet) {
+        cout << "--------------------" << endl;
+        for (int i = 0; i < n; ++i) {
+            cout << "Node " << i << ": ";
+            if (dist[i] == numeric_limits<double>::infinity())
+                cout << "INF";
+            else
+                cout << dist[i];
+            cout << endl;
+        }
+    }
+
+    return 0;
+}
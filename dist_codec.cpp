@@ -0,0 +1,222 @@
+#include "dist_codec.h"
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+
+using namespace std;
+
+static const char DIST_MAGIC[4] = {'B', 'M', 'D', 'V'};
+static const uint32_t DIST_VERSION = 1;
+
+static inline int bit_width(uint64_t v) {
+    int w = 0;
+    while (v) {
+        w++;
+        v >>= 1;
+    }
+    return w;
+}
+
+CompressedDistances::CompressedDistances(const vector<double>& dist,
+                                         double res)
+    : n((int)dist.size()), resolution(res) {
+    if (!(resolution > 0))
+        throw invalid_argument("resolution must be positive");
+
+    int blocks = (n + BLOCK - 1) / BLOCK;
+    inf_bits.assign(blocks, 0);
+    block_base.assign(blocks, 0);
+    block_start.assign(blocks, 0);
+    block_width.assign(blocks, 0);
+
+    const double max_q = (double)(1ULL << 62);
+    vector<uint64_t> q(BLOCK);
+    uint64_t bit_pos = 0;
+
+    for (int b = 0; b < blocks; ++b) {
+        int begin = b * BLOCK;
+        int end = min(n, begin + BLOCK);
+        uint64_t lo = numeric_limits<uint64_t>::max();
+        uint64_t hi = 0;
+
+        for (int i = begin; i < end; ++i) {
+            double d = dist[i];
+            if (d == numeric_limits<double>::infinity()) {
+                inf_bits[b] |= 1ULL << (i - begin);
+                continue;
+            }
+            if (!(d >= 0))
+                throw invalid_argument("distances must be non-negative");
+            double scaled = nearbyint(d / resolution);
+            if (scaled >= max_q)
+                throw overflow_error("distance exceeds quantization range");
+            q[i - begin] = (uint64_t)scaled;
+            lo = min(lo, q[i - begin]);
+            hi = max(hi, q[i - begin]);
+        }
+
+        if (lo > hi) // all entries unreachable
+            lo = hi = 0;
+        int width = bit_width(hi - lo);
+        block_base[b] = lo;
+        block_width[b] = (uint8_t)width;
+        block_start[b] = bit_pos;
+        bit_pos += (uint64_t)width * (end - begin);
+    }
+
+    // One spare word lets get_bits read across a word boundary unchecked.
+    packed.assign(bit_pos / 64 + 2, 0);
+
+    for (int b = 0; b < blocks; ++b) {
+        int width = block_width[b];
+        if (width == 0)
+            continue;
+        int begin = b * BLOCK;
+        int end = min(n, begin + BLOCK);
+        uint64_t pos = block_start[b];
+        for (int i = begin; i < end; ++i, pos += width) {
+            if ((inf_bits[b] >> (i - begin)) & 1)
+                continue;
+            uint64_t v =
+                (uint64_t)nearbyint(dist[i] / resolution) - block_base[b];
+            size_t w = pos >> 6;
+            int off = pos & 63;
+            packed[w] |= v << off;
+            if (off + width > 64)
+                packed[w + 1] |= v >> (64 - off);
+        }
+    }
+}
+
+uint64_t CompressedDistances::get_bits(uint64_t pos, int width) const {
+    if (width == 0)
+        return 0;
+    size_t w = pos >> 6;
+    int off = pos & 63;
+    uint64_t v = packed[w] >> off;
+    if (off + width > 64)
+        v |= packed[w + 1] << (64 - off);
+    return width == 64 ? v : v & ((1ULL << width) - 1);
+}
+
+double CompressedDistances::operator[](int i) const {
+    if (is_unreachable(i))
+        return numeric_limits<double>::infinity();
+    int b = i / BLOCK;
+    int width = block_width[b];
+    uint64_t v = get_bits(block_start[b] + (uint64_t)(i - b * BLOCK) * width,
+                          width);
+    return (double)(block_base[b] + v) * resolution;
+}
+
+void CompressedDistances::decode(vector<double>& out) const {
+    out.resize(n);
+    int blocks = (int)block_base.size();
+    for (int b = 0; b < blocks; ++b) {
+        int begin = b * BLOCK;
+        int end = min(n, begin + BLOCK);
+        int width = block_width[b];
+        uint64_t pos = block_start[b];
+        uint64_t inf_mask = inf_bits[b];
+        for (int i = begin; i < end; ++i, pos += width) {
+            if ((inf_mask >> (i - begin)) & 1)
+                out[i] = numeric_limits<double>::infinity();
+            else
+                out[i] =
+                    (double)(block_base[b] + get_bits(pos, width)) * resolution;
+        }
+    }
+}
+
+vector<double> CompressedDistances::decode() const {
+    vector<double> out;
+    decode(out);
+    return out;
+}
+
+size_t CompressedDistances::bytes() const {
+    return inf_bits.size() * sizeof(uint64_t) +
+           block_base.size() * sizeof(uint64_t) +
+           block_start.size() * sizeof(uint64_t) +
+           block_width.size() * sizeof(uint8_t) +
+           packed.size() * sizeof(uint64_t);
+}
+
+template <typename T>
+static void write_array(ostream& out, const vector<T>& v) {
+    uint64_t count = v.size();
+    out.write((const char*)&count, sizeof(count));
+    out.write((const char*)v.data(), count * sizeof(T));
+}
+
+// Reads an array whose length must be `expected`, so a corrupt count is
+// rejected before anything is allocated for it.
+template <typename T>
+static bool read_array(istream& in, vector<T>& v, uint64_t expected) {
+    uint64_t count;
+    if (!in.read((char*)&count, sizeof(count)) || count != expected)
+        return false;
+    v.resize(count);
+    return (bool)in.read((char*)v.data(), count * sizeof(T));
+}
+
+bool CompressedDistances::write(ostream& out) const {
+    int32_t n32 = n;
+    out.write(DIST_MAGIC, sizeof(DIST_MAGIC));
+    out.write((const char*)&DIST_VERSION, sizeof(DIST_VERSION));
+    out.write((const char*)&n32, sizeof(n32));
+    out.write((const char*)&resolution, sizeof(resolution));
+    write_array(out, inf_bits);
+    write_array(out, block_base);
+    write_array(out, block_start);
+    write_array(out, block_width);
+    write_array(out, packed);
+    return (bool)out;
+}
+
+bool CompressedDistances::read(istream& in) {
+    char magic[4];
+    uint32_t version;
+    int32_t n32;
+    if (!in.read(magic, sizeof(magic)) ||
+        !equal(magic, magic + 4, DIST_MAGIC))
+        return false;
+    if (!in.read((char*)&version, sizeof(version)) || version != DIST_VERSION)
+        return false;
+    if (!in.read((char*)&n32, sizeof(n32)) ||
+        !in.read((char*)&resolution, sizeof(resolution)))
+        return false;
+    if (n32 < 0 || !(resolution > 0))
+        return false;
+    n = n32;
+    int blocks = (n + BLOCK - 1) / BLOCK;
+    if (!read_array(in, inf_bits, blocks) ||
+        !read_array(in, block_base, blocks) ||
+        !read_array(in, block_start, blocks) ||
+        !read_array(in, block_width, blocks))
+        return false;
+    // The widths fix the packed length, with the spare word get_bits may
+    // touch.
+    uint64_t bits = 0;
+    for (int b = 0; b < blocks; ++b) {
+        if (block_width[b] > 64)
+            return false;
+        bits += (uint64_t)block_width[b] * min(BLOCK, n - b * BLOCK);
+    }
+    if (!read_array(in, packed, bits / 64 + 2))
+        return false;
+    // Every block must lie inside packed, so a corrupt file cannot steer
+    // reads out of bounds.
+    uint64_t bit_limit = (uint64_t)(packed.size() - 1) * 64;
+    for (int b = 0; b < blocks; ++b) {
+        if (block_start[b] > bit_limit)
+            return false;
+        int count = min(BLOCK, n - b * BLOCK);
+        if ((uint64_t)block_width[b] * count > bit_limit - block_start[b])
+            return false;
+    }
+    return true;
+}
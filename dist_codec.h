@@ -0,0 +1,58 @@
+#ifndef DIST_CODEC_H
+#define DIST_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+using namespace std;
+
+// Compact, randomly accessible encoding of a distance vector.
+//
+// Finite distances are quantized to fixed point (round(d / resolution)) and
+// stored per block of 64 entries as a frame-of-reference delta: the block
+// minimum plus a bit-packed offset of the block's width for every entry.
+// Unreachable (INF) entries are flagged in a separate bitmap and take no
+// value bits beyond their slot in the block.
+struct CompressedDistances {
+    static constexpr int BLOCK = 64;
+
+    int n = 0;
+    double resolution = 1e-6;
+
+    vector<uint64_t> inf_bits;    // bit i set: entry i is unreachable
+    vector<uint64_t> block_base;  // quantized minimum of each block
+    vector<uint64_t> block_start; // bit offset of each block in packed
+    vector<uint8_t> block_width;  // bits per entry of each block
+    vector<uint64_t> packed;      // bit-packed offsets from block_base
+
+    CompressedDistances() = default;
+
+    // Throws overflow_error if a distance does not fit in 62 bits at the
+    // requested resolution, and invalid_argument on negative or NaN input.
+    CompressedDistances(const vector<double>& dist, double resolution);
+
+    double operator[](int i) const;
+
+    bool is_unreachable(int i) const {
+        return (inf_bits[i >> 6] >> (i & 63)) & 1;
+    }
+
+    // Decodes every entry into `out` (resized to n).
+    void decode(vector<double>& out) const;
+    vector<double> decode() const;
+
+    // Heap footprint of the encoded arrays.
+    size_t bytes() const;
+
+    // Versioned little-endian on-disk format. read() rejects files whose
+    // block table points outside the packed data.
+    bool write(ostream& out) const;
+    bool read(istream& in);
+
+  private:
+    uint64_t get_bits(uint64_t pos, int width) const;
+};
+
+#endif // DIST_CODEC_H
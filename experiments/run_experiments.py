@@ -2,6 +2,10 @@
 """BMSSP solver experiment runner.
 
 Generates random graphs, runs the solver, and logs per-trial results to CSV files.
+When the bmssp Python extension is built (-DBMSSP_BUILD_PYTHON=ON) and no
+Dijkstra baseline is run, BMSSP runs in-process on CSR arrays; otherwise every
+trial goes through a graph file and the solver binary, so BMSSP and Dijkstra
+are timed on the same adjacency lists. The "mode" column records which.
 """
 
 import argparse
@@ -13,6 +17,8 @@ import struct
 import subprocess
 import sys
 import tempfile
+import time
+from array import array
 
 WEIGHT_MIN = 0.1
 WEIGHT_MAX = 100.0
@@ -74,11 +80,11 @@ def write_graph_to_file(filepath, n, edges, source=0):
 def write_graph_binary(filepath, n, edges, source=0):
     """Write graph in binary format for fast solver I/O.
 
-    Format: [int32 n][int32 m][int32 source] then m × [int32 u][int32 v][float64 w]
+    Format: [int32 n][uint32 m][int32 source] then m × [int32 u][int32 v][float64 w]
     """
     m = len(edges)
     with open(filepath, "wb") as f:
-        f.write(struct.pack("<iii", n, m, source))
+        f.write(struct.pack("<iIi", n, m, source))
         for u, v, w in edges:
             f.write(struct.pack("<iid", u, v, w))
 
@@ -118,13 +124,69 @@ def run_solver(solver_path, input_file, label="BMSSP", timeout=300, binary=False
         return 0.0, False
 
 
+def load_bindings(build_dir):
+    """Import the bmssp extension module from build_dir, or return None."""
+    sys.path.insert(0, build_dir)
+    try:
+        import bmssp
+        return bmssp
+    except ImportError:
+        return None
+    finally:
+        sys.path.pop(0)
+
+
+def edges_to_csr(n, edges):
+    """Counting-sort an edge list into CSR arrays (int64, int32, float64)."""
+    counts = [0] * (n + 1)
+    for u, _, _ in edges:
+        counts[u + 1] += 1
+    for u in range(n):
+        counts[u + 1] += counts[u]
+    offsets = array("q", counts)
+    cursor = counts[:n]
+    targets = array("i", bytes(4 * len(edges)))
+    weights = array("d", bytes(8 * len(edges)))
+    for u, v, w in edges:
+        i = cursor[u]
+        cursor[u] = i + 1
+        targets[i] = v
+        weights[i] = w
+    return offsets, targets, weights
+
+
+def run_bindings(bindings, n, edges, source=0):
+    """Solve in-process through the extension module. Returns (time_ms, success)."""
+    try:
+        graph = bindings.Graph(*edges_to_csr(n, edges))
+        start = time.perf_counter()
+        graph.solve(source)
+        return (time.perf_counter() - start) * 1000.0, True
+    except Exception as e:
+        print(f"  Error: {e}")
+        return 0.0, False
+
+
+def run_trial(solver_name, solver_path, label, bindings, n, edges, tmpdir):
+    """Time one solver on one graph, in-process when the bindings are loaded.
+
+    Returns (time_ms, success, mode) with mode "bindings" or "binary".
+    """
+    if solver_name == "bmssp" and bindings is not None:
+        return run_bindings(bindings, n, edges) + ("bindings",)
+    graph_file = os.path.join(tmpdir, "graph.bin")
+    if not os.path.exists(graph_file):
+        write_graph_binary(graph_file, n, edges)
+    return run_solver(solver_path, graph_file, label, binary=True) + ("binary",)
+
+
 def make_seed(n, m, trial):
     """Deterministic seed derived from experiment configuration."""
     return hash((n, m, trial)) & 0x7FFFFFFF
 
 
 def run_node_scaling(solver_path, node_counts, edge_multiplier, trials, output_dir,
-                     dijkstra_path=None):
+                     dijkstra_path=None, bindings=None):
     """Run node-scaling experiment and write results to CSV."""
     csv_path = os.path.join(output_dir, "node_scaling.csv")
     print("=" * 60)
@@ -142,7 +204,7 @@ def run_node_scaling(solver_path, node_counts, edge_multiplier, trials, output_d
 
     with open(csv_path, "w", newline="") as f:
         writer = csv.writer(f)
-        writer.writerow(["nodes", "edges", "trial", "seed", "solver", "time_ms"])
+        writer.writerow(["nodes", "edges", "trial", "seed", "solver", "mode", "time_ms"])
 
         with tempfile.TemporaryDirectory() as tmpdir:
             for n in node_counts:
@@ -150,13 +212,16 @@ def run_node_scaling(solver_path, node_counts, edge_multiplier, trials, output_d
                 print(f"\nn={n:,}, m={m:,}")
                 for trial in range(trials):
                     seed = make_seed(n, m, trial)
-                    graph_file = os.path.join(tmpdir, "graph.bin")
                     edges = generate_connected_graph(n, m, seed=seed)
-                    write_graph_binary(graph_file, n, edges)
+                    graph_file = os.path.join(tmpdir, "graph.bin")
+                    if os.path.exists(graph_file):
+                        os.remove(graph_file)
                     for solver_name, spath, label in solvers:
-                        timing, success = run_solver(spath, graph_file, label, binary=True)
+                        timing, success, mode = run_trial(
+                            solver_name, spath, label, bindings, n, edges, tmpdir
+                        )
                         if success:
-                            writer.writerow([n, m, trial, seed, solver_name, f"{timing:.4f}"])
+                            writer.writerow([n, m, trial, seed, solver_name, mode, f"{timing:.4f}"])
                             print(f"  Trial {trial+1}/{trials} [{solver_name}]: {timing:.2f} ms")
                         else:
                             print(f"  Trial {trial+1}/{trials} [{solver_name}]: FAILED")
@@ -165,7 +230,7 @@ def run_node_scaling(solver_path, node_counts, edge_multiplier, trials, output_d
 
 
 def run_edge_density(solver_path, fixed_nodes, edge_multipliers, trials, output_dir,
-                     dijkstra_path=None):
+                     dijkstra_path=None, bindings=None):
     """Run edge-density experiment and write results to CSV."""
     csv_path = os.path.join(output_dir, "edge_density.csv")
     print("\n" + "=" * 60)
@@ -183,7 +248,8 @@ def run_edge_density(solver_path, fixed_nodes, edge_multipliers, trials, output_
 
     with open(csv_path, "w", newline="") as f:
         writer = csv.writer(f)
-        writer.writerow(["nodes", "edges", "multiplier", "trial", "seed", "solver", "time_ms"])
+        writer.writerow(["nodes", "edges", "multiplier", "trial", "seed", "solver", "mode",
+                         "time_ms"])
 
         with tempfile.TemporaryDirectory() as tmpdir:
             for multiplier in edge_multipliers:
@@ -192,13 +258,17 @@ def run_edge_density(solver_path, fixed_nodes, edge_multipliers, trials, output_
                 print(f"\nn={n:,}, m={m:,} (multiplier={multiplier})")
                 for trial in range(trials):
                     seed = make_seed(n, m, trial)
-                    graph_file = os.path.join(tmpdir, "graph.bin")
                     edges = generate_connected_graph(n, m, seed=seed)
-                    write_graph_binary(graph_file, n, edges)
+                    graph_file = os.path.join(tmpdir, "graph.bin")
+                    if os.path.exists(graph_file):
+                        os.remove(graph_file)
                     for solver_name, spath, label in solvers:
-                        timing, success = run_solver(spath, graph_file, label, binary=True)
+                        timing, success, mode = run_trial(
+                            solver_name, spath, label, bindings, n, edges, tmpdir
+                        )
                         if success:
-                            writer.writerow([n, m, multiplier, trial, seed, solver_name, f"{timing:.4f}"])
+                            writer.writerow([n, m, multiplier, trial, seed, solver_name, mode,
+                                             f"{timing:.4f}"])
                             print(f"  Trial {trial+1}/{trials} [{solver_name}]: {timing:.2f} ms")
                         else:
                             print(f"  Trial {trial+1}/{trials} [{solver_name}]: FAILED")
@@ -276,13 +346,18 @@ def main():
         help="Skip the Dijkstra baseline comparison",
     )
 
-    args = parser.parse_args()
+    parser.add_argument(
+        "--bindings-dir",
+        default="../build",
+        help="Directory holding the bmssp Python extension (default: ../build)",
+    )
+    parser.add_argument(
+        "--no-bindings",
+        action="store_true",
+        help="Run BMSSP through the solver binary even if the extension is built",
+    )
 
-    solver_path = os.path.abspath(args.solver)
-    if not os.path.isfile(solver_path):
-        print(f"Error: Solver not found at {solver_path}", file=sys.stderr)
-        print("Build it first: cd .. && cmake -B build && cmake --build build", file=sys.stderr)
-        sys.exit(1)
+    args = parser.parse_args()
 
     dijkstra_path = None
     if not args.skip_dijkstra:
@@ -293,18 +368,36 @@ def main():
         else:
             print(f"Warning: Dijkstra solver not found at {dp}, skipping baseline")
 
+    # The Dijkstra baseline only runs through its binary, so BMSSP does too
+    # when it is enabled: both then load the same file into the same
+    # representation.
+    bindings = None
+    if not args.no_bindings and dijkstra_path is None:
+        bindings = load_bindings(os.path.abspath(args.bindings_dir))
+        if bindings is not None:
+            print(f"BMSSP: in-process via {bindings.__file__}")
+    elif not args.no_bindings:
+        print("BMSSP: solver binary, to match the Dijkstra baseline "
+              "(--skip-dijkstra runs it in-process)")
+
+    solver_path = os.path.abspath(args.solver)
+    if bindings is None and not os.path.isfile(solver_path):
+        print(f"Error: Solver not found at {solver_path}", file=sys.stderr)
+        print("Build it first: cd .. && cmake -B build && cmake --build build", file=sys.stderr)
+        sys.exit(1)
+
     os.makedirs(args.output_dir, exist_ok=True)
 
     if not args.skip_node_scaling:
         run_node_scaling(
             solver_path, args.node_counts, args.edge_multiplier, args.trials, args.output_dir,
-            dijkstra_path,
+            dijkstra_path, bindings,
         )
 
     if not args.skip_edge_density:
         run_edge_density(
             solver_path, args.fixed_nodes, args.edge_multipliers, args.trials, args.output_dir,
-            dijkstra_path,
+            dijkstra_path, bindings,
         )
 
     print("\nAll experiments complete.")
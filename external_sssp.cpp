@@ -0,0 +1,149 @@
+#include "external_sssp.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+BlockBuffer::BlockBuffer(const CsrView& g, int nodes, size_t budget)
+    : graph(g), block_nodes(max(1, nodes)), budget_bytes(budget) {}
+
+size_t BlockBuffer::block_bytes(int b) const {
+    vertex_t begin = (vertex_t)b * block_nodes;
+    vertex_t end = min<vertex_t>(graph.n, begin + block_nodes);
+    edge_t edges = graph.offsets[end] - graph.offsets[begin];
+    return (size_t)edges * (sizeof(vertex_t) + sizeof(double));
+}
+
+// Applies `advice` to the pages holding the targets and weights of block b.
+void BlockBuffer::advise(int b, int advice) const {
+    static const uintptr_t page = sysconf(_SC_PAGESIZE);
+    vertex_t begin = (vertex_t)b * block_nodes;
+    vertex_t end = min<vertex_t>(graph.n, begin + block_nodes);
+    edge_t first = graph.offsets[begin], last = graph.offsets[end];
+    if (first == last)
+        return;
+    auto apply = [&](const void* lo, const void* hi) {
+        uintptr_t start = (uintptr_t)lo / page * page;
+        // Only whole pages owned by this block are dropped; shared boundary
+        // pages stay mapped.
+        if (advice == MADV_DONTNEED) {
+            start = ((uintptr_t)lo + page - 1) / page * page;
+            uintptr_t stop = (uintptr_t)hi / page * page;
+            if (stop > start)
+                madvise((void*)start, stop - start, advice);
+            return;
+        }
+        madvise((void*)start, (uintptr_t)hi - start, advice);
+    };
+    apply(graph.targets + first, graph.targets + last);
+    apply(graph.weights + first, graph.weights + last);
+}
+
+void BlockBuffer::acquire(int b) {
+    auto it = resident.find(b);
+    if (it != resident.end()) {
+        lru.splice(lru.begin(), lru, it->second);
+        stats.hits++;
+        return;
+    }
+
+    size_t bytes = block_bytes(b);
+    while (!lru.empty() && resident_bytes + bytes > budget_bytes) {
+        int victim = lru.back();
+        lru.pop_back();
+        resident.erase(victim);
+        resident_bytes -= block_bytes(victim);
+        advise(victim, MADV_DONTNEED);
+        stats.evictions++;
+    }
+    advise(b, MADV_WILLNEED);
+    lru.push_front(b);
+    resident[b] = lru.begin();
+    resident_bytes += bytes;
+    stats.loads++;
+    stats.bytes_loaded += bytes;
+}
+
+vector<double> external_sssp(const CsrView& graph, vertex_t source,
+                             const ExternalOptions& opts,
+                             BlockBuffer::Stats* stats,
+                             uint64_t* block_rounds) {
+    const double INF = numeric_limits<double>::infinity();
+    vector<double> dist(graph.n, INF);
+    if (source < 0 || source >= graph.n)
+        return dist;
+
+    BlockBuffer buffer(graph, opts.block_nodes, opts.buffer_bytes);
+    int blocks = buffer.block_count();
+    vector<vector<vertex_t>> pending(blocks);
+    vector<double> block_min(blocks, INF);
+    vector<char> queued(graph.n, 0);
+    typedef pair<double, int> BlockKey;
+    priority_queue<BlockKey, vector<BlockKey>, greater<BlockKey>> block_queue;
+
+    auto enqueue = [&](vertex_t v) {
+        int b = buffer.block_of(v);
+        if (!queued[v]) {
+            queued[v] = 1;
+            pending[b].push_back(v);
+        }
+        if (dist[v] < block_min[b]) {
+            block_min[b] = dist[v];
+            block_queue.push({dist[v], b});
+        }
+    };
+
+    dist[source] = 0;
+    enqueue(source);
+
+    uint64_t rounds = 0;
+    typedef pair<double, vertex_t> NodeKey;
+    priority_queue<NodeKey, vector<NodeKey>, greater<NodeKey>> local;
+    while (!block_queue.empty()) {
+        BlockKey top = block_queue.top();
+        block_queue.pop();
+        int b = top.second;
+        if (top.first != block_min[b] || pending[b].empty())
+            continue; // stale key
+        rounds++;
+
+        buffer.acquire(b);
+        for (vertex_t v : pending[b]) {
+            queued[v] = 0;
+            local.push({dist[v], v});
+        }
+        pending[b].clear();
+        block_min[b] = INF;
+
+        // Local Dijkstra over the resident block. Improvements to nodes of
+        // other blocks are queued for their own batch.
+        while (!local.empty()) {
+            NodeKey cur = local.top();
+            local.pop();
+            if (cur.first > dist[cur.second])
+                continue;
+            for (const auto& e : graph[cur.second]) {
+                double d = cur.first + e.weight;
+                if (d >= dist[e.to])
+                    continue;
+                dist[e.to] = d;
+                if (buffer.block_of(e.to) == b)
+                    local.push({d, e.to});
+                else
+                    enqueue(e.to);
+            }
+        }
+    }
+
+    if (stats)
+        *stats = buffer.stats;
+    if (block_rounds)
+        *block_rounds = rounds;
+    return dist;
+}
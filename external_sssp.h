@@ -0,0 +1,65 @@
+#ifndef EXTERNAL_SSSP_H
+#define EXTERNAL_SSSP_H
+
+#include "csr_graph.h"
+#include "types.h"
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Buffer manager for a memory-mapped CSR graph split into blocks of
+// consecutive nodes. At most `budget_bytes` of edge data is kept resident:
+// acquiring a block asks the kernel to read its whole edge range ahead
+// (MADV_WILLNEED, one sequential read), and the least recently used blocks
+// are released with MADV_DONTNEED once the budget is exceeded.
+struct BlockBuffer {
+    struct Stats {
+        uint64_t loads = 0;
+        uint64_t hits = 0;
+        uint64_t evictions = 0;
+        uint64_t bytes_loaded = 0;
+    };
+
+    const CsrView& graph;
+    int block_nodes;
+    size_t budget_bytes;
+    size_t resident_bytes = 0;
+    Stats stats;
+
+    BlockBuffer(const CsrView& graph, int block_nodes, size_t budget_bytes);
+
+    int block_count() const {
+        return (graph.n + block_nodes - 1) / block_nodes;
+    }
+    int block_of(vertex_t v) const { return v / block_nodes; }
+
+    // Makes block b resident and marks it most recently used.
+    void acquire(int b);
+
+  private:
+    list<int> lru; // most recent first
+    unordered_map<int, list<int>::iterator> resident;
+
+    size_t block_bytes(int b) const;
+    void advise(int b, int advice) const;
+};
+
+struct ExternalOptions {
+    int block_nodes = 1 << 16;
+    size_t buffer_bytes = (size_t)256 << 20;
+};
+
+// Label-correcting SSSP for graphs whose edges do not fit in memory. Only
+// the distance labels live in RAM. Improved nodes are queued per block; the
+// block holding the smallest queued label is loaded and relaxed as a batch
+// with a local Dijkstra, so edge data is read block by block instead of
+// edge by edge. Nodes improved again later are simply queued again.
+vector<double> external_sssp(const CsrView& graph, vertex_t source,
+                             const ExternalOptions& opts,
+                             BlockBuffer::Stats* stats = nullptr,
+                             uint64_t* block_rounds = nullptr);
+
+#endif // EXTERNAL_SSSP_H
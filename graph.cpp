@@ -0,0 +1,20 @@
+#include "graph.h"
+
+using namespace std;
+
+vector<vector<Edge>> reverse_graph(vertex_t n,
+                                   const vector<vector<Edge>>& adj) {
+    // Count in-degrees first so each row is allocated exactly once.
+    vector<int> in_deg(n, 0);
+    for (int u = 0; u < n; ++u)
+        for (const auto& e : adj[u])
+            in_deg[e.to]++;
+
+    vector<vector<Edge>> radj(n);
+    for (int v = 0; v < n; ++v)
+        radj[v].reserve(in_deg[v]);
+    for (int u = 0; u < n; ++u)
+        for (const auto& e : adj[u])
+            radj[e.to].push_back({u, e.weight});
+    return radj;
+}
@@ -0,0 +1,12 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Transposed adjacency: an edge u -> v of weight w becomes v -> u.
+vector<vector<Edge>> reverse_graph(vertex_t n, const vector<vector<Edge>>& adj);
+
+#endif // GRAPH_H
@@ -0,0 +1,158 @@
+#include "graph_io.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Binary edges are read in chunks of this many records; out-of-range edges
+// are dropped per chunk.
+static const size_t READ_CHUNK = 1 << 20;
+
+static bool in_range(const BinaryEdge& e, vertex_t n) {
+    return e.u >= 0 && e.u < n && e.v >= 0 && e.v < n;
+}
+
+// Edge records left in stdin when it is a regular file, -1 when unknown
+// (a pipe).
+static edge_t records_left() {
+    struct stat st;
+    off_t pos = ftello(stdin);
+    if (pos < 0 || fstat(fileno(stdin), &st) != 0 || !S_ISREG(st.st_mode))
+        return -1;
+    return (edge_t)((st.st_size - pos) / (off_t)sizeof(BinaryEdge));
+}
+
+// Keeps an in-range edge, or records it and returns false when its weight is
+// negative (or NaN). The check is one comparison on a value already loaded.
+static bool accept_edge(const BinaryEdge& e, edge_t index, GraphInput& g,
+                        vector<BinaryEdge>& edges) {
+    if (!in_range(e, g.n))
+        return true;
+    if (!(e.w >= 0)) {
+        g.bad_edge = e;
+        g.bad_index = index;
+        return false;
+    }
+    edges.push_back(e);
+    return true;
+}
+
+// Lays out adjacency rows with exact capacities: one counting pass over the
+// edge list, then a scatter pass. The transposed rows are filled in the
+// same pass, keyed on edge targets.
+static void build_adjacency(const vector<BinaryEdge>& edges, bool with_reverse,
+                            GraphInput& g) {
+    vertex_t n = g.n;
+    vector<edge_t> out_deg(n, 0), in_deg;
+    if (with_reverse)
+        in_deg.assign(n, 0);
+    for (const auto& e : edges) {
+        out_deg[e.u]++;
+        if (with_reverse)
+            in_deg[e.v]++;
+    }
+
+    g.adj.assign(n, {});
+    for (vertex_t u = 0; u < n; ++u)
+        g.adj[u].reserve(out_deg[u]);
+    if (with_reverse) {
+        g.radj.assign(n, {});
+        for (vertex_t v = 0; v < n; ++v)
+            g.radj[v].reserve(in_deg[v]);
+    }
+
+    for (const auto& e : edges) {
+        g.adj[e.u].push_back({e.v, e.w});
+        if (with_reverse)
+            g.radj[e.v].push_back({e.u, e.w});
+    }
+}
+
+LoadStatus load_edges(bool binary, GraphInput& g, vector<BinaryEdge>& edges) {
+    edges.clear();
+    if (binary) {
+        BinaryHeader header;
+        if (fread(&header, sizeof(header), 1, stdin) != 1)
+            return LOAD_EMPTY;
+        g.n = header.n;
+        g.m = header.m;
+        g.source = header.source;
+
+        // The edge list is reserved in one piece once the file is known to
+        // hold m records; from a pipe it grows as chunks arrive, so a
+        // corrupt header cannot demand memory for edges that never come.
+        edge_t left = records_left();
+        if (left >= 0 && left < g.m)
+            return LOAD_TRUNCATED;
+        edges.reserve(left >= 0 ? g.m : min<edge_t>(g.m, READ_CHUNK));
+        vector<BinaryEdge> chunk(min((size_t)g.m, READ_CHUNK));
+        for (edge_t done = 0; done < g.m;) {
+            size_t count = (size_t)min<edge_t>(g.m - done, chunk.size());
+            if (fread(chunk.data(), sizeof(BinaryEdge), count, stdin) != count)
+                return LOAD_TRUNCATED;
+            for (size_t i = 0; i < count; ++i)
+                if (!accept_edge(chunk[i], done + i, g, edges))
+                    return LOAD_NEGATIVE_WEIGHT;
+            done += count;
+        }
+    } else {
+        if (!(cin >> g.n >> g.m))
+            return LOAD_EMPTY;
+        // As with a pipe, the list grows past one chunk only as edges
+        // actually arrive.
+        edges.reserve((size_t)max<edge_t>(0, min<edge_t>(g.m, READ_CHUNK)));
+        BinaryEdge e;
+        for (edge_t i = 0; i < g.m; ++i) {
+            if (!(cin >> e.u >> e.v >> e.w))
+                return LOAD_TRUNCATED;
+            if (!accept_edge(e, i, g, edges))
+                return LOAD_NEGATIVE_WEIGHT;
+        }
+        cin >> g.source;
+    }
+    return LOAD_OK;
+}
+
+LoadStatus load_graph(bool binary, bool with_reverse, GraphInput& g) {
+    vector<BinaryEdge> edges;
+    LoadStatus status = load_edges(binary, g, edges);
+    if (status == LOAD_OK)
+        build_adjacency(edges, with_reverse, g);
+    return status;
+}
+
+void report_load_error(LoadStatus status, const GraphInput& g) {
+    if (status == LOAD_TRUNCATED)
+        cerr << "Truncated graph input" << endl;
+    else if (status == LOAD_NEGATIVE_WEIGHT)
+        cerr << "Edge " << g.bad_index << " (" << g.bad_edge.u << " -> "
+             << g.bad_edge.v << ") has weight " << g.bad_edge.w
+             << "; weights must be non-negative" << endl;
+}
+
+bool write_graph(const char* path, vertex_t n,
+                 const vector<vector<Edge>>& adj, vertex_t source) {
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    vector<BinaryEdge> edges;
+    for (int u = 0; u < n; ++u)
+        for (const auto& e : adj[u])
+            edges.push_back({u, e.to, e.weight});
+
+    if (edges.size() > UINT32_MAX) {
+        fclose(f);
+        return false;
+    }
+    BinaryHeader header = {n, (uint32_t)edges.size(), source};
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(edges.data(), sizeof(BinaryEdge), edges.size(), f) ==
+                  edges.size();
+    return fclose(f) == 0 && ok;
+}
@@ -0,0 +1,57 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include "types.h"
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// On-disk records of the binary graph format. The edge count is unsigned,
+// so files written by older versions (non-negative int32) read unchanged.
+struct BinaryHeader {
+    int32_t n;
+    uint32_t m;
+    int32_t source;
+};
+
+struct BinaryEdge {
+    vertex_t u, v;
+    double w;
+};
+
+struct GraphInput {
+    vertex_t n = 0;
+    edge_t m = 0;
+    vertex_t source = 0;
+    vector<vector<Edge>> adj;
+    vector<vector<Edge>> radj; // transposed graph, when requested
+
+    // The first rejected edge and its position in the input, set when
+    // loading stops with LOAD_NEGATIVE_WEIGHT.
+    BinaryEdge bad_edge = {0, 0, 0};
+    edge_t bad_index = -1;
+};
+
+enum LoadStatus { LOAD_OK, LOAD_EMPTY, LOAD_TRUNCATED, LOAD_NEGATIVE_WEIGHT };
+
+// Reads a graph from stdin in the text or binary format described in the
+// README. Edges with an endpoint outside [0, n) are dropped. With
+// `with_reverse`, radj is built alongside adj from the same edge list.
+// Loading stops at the first in-range edge whose weight is negative or NaN:
+// every solver assumes non-negative weights.
+LoadStatus load_graph(bool binary, bool with_reverse, GraphInput& g);
+
+// Same checks, but leaves the in-range edges as a list in input order
+// instead of building adj (see build_csr in csr_graph.h).
+LoadStatus load_edges(bool binary, GraphInput& g, vector<BinaryEdge>& edges);
+
+// Prints a one-line description of a failed load to stderr.
+void report_load_error(LoadStatus status, const GraphInput& g);
+
+// Writes the graph in the binary input format. Returns false on I/O error
+// or when the edge count does not fit the header.
+bool write_graph(const char* path, vertex_t n,
+                 const vector<vector<Edge>>& adj, vertex_t source);
+
+#endif // GRAPH_IO_H
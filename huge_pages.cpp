@@ -0,0 +1,160 @@
+#include "huge_pages.h"
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+namespace {
+
+struct Mapping {
+    void* base;
+    size_t length;
+};
+
+atomic<int> current_mode(HUGE_OFF);
+mutex registry_mutex;
+unordered_map<void*, Mapping> registry; // payload -> mapping to release
+HugePageStats stats;
+
+size_t round_up(size_t bytes, size_t align) {
+    return (bytes + align - 1) / align * align;
+}
+
+#ifdef __linux__
+void* map_explicit(size_t length) {
+#ifdef MAP_HUGETLB
+    void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+#else
+    (void)length;
+    return nullptr;
+#endif
+}
+
+// Maps one extra huge page and trims it so the region starts on a 2 MB
+// boundary; otherwise the kernel cannot use huge pages for the head.
+void* map_transparent(size_t length, Mapping& m) {
+    size_t padded = length + HUGE_PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return nullptr;
+    uintptr_t start = (uintptr_t)raw;
+    uintptr_t aligned = round_up(start, HUGE_PAGE_SIZE);
+    if (aligned > start)
+        munmap(raw, aligned - start);
+    size_t tail = padded - (aligned - start) - length;
+    if (tail > 0)
+        munmap((void*)(aligned + length), tail);
+#ifdef MADV_HUGEPAGE
+    madvise((void*)aligned, length, MADV_HUGEPAGE);
+#endif
+    m = {(void*)aligned, length};
+    return (void*)aligned;
+}
+#endif
+
+} // namespace
+
+void set_huge_page_mode(HugePageMode mode) {
+    current_mode = mode;
+}
+
+HugePageMode huge_page_mode() {
+    return (HugePageMode)current_mode.load();
+}
+
+bool parse_huge_page_mode(const char* name, HugePageMode& mode) {
+    if (strcmp(name, "off") == 0)
+        mode = HUGE_OFF;
+    else if (strcmp(name, "thp") == 0)
+        mode = HUGE_THP;
+    else if (strcmp(name, "explicit") == 0)
+        mode = HUGE_EXPLICIT;
+    else
+        return false;
+    return true;
+}
+
+const char* huge_page_mode_name(HugePageMode mode) {
+    switch (mode) {
+    case HUGE_THP:
+        return "thp";
+    case HUGE_EXPLICIT:
+        return "explicit";
+    default:
+        return "off";
+    }
+}
+
+HugePageStats huge_page_stats() {
+    lock_guard<mutex> lock(registry_mutex);
+    return stats;
+}
+
+void* huge_alloc(size_t bytes) {
+    HugePageMode mode = huge_page_mode();
+#ifdef __linux__
+    if (mode != HUGE_OFF && bytes >= HUGE_PAGE_SIZE) {
+        size_t length = round_up(bytes, HUGE_PAGE_SIZE);
+        Mapping m = {nullptr, 0};
+        void* p = nullptr;
+        bool fallback = false;
+        if (mode == HUGE_EXPLICIT) {
+            p = map_explicit(length);
+            m = {p, length};
+            fallback = p == nullptr;
+        }
+        bool explicit_page = p != nullptr;
+        if (!p)
+            p = map_transparent(length, m);
+        if (p) {
+            lock_guard<mutex> lock(registry_mutex);
+            registry[p] = m;
+            (explicit_page ? stats.explicit_bytes : stats.thp_bytes) += length;
+            if (fallback)
+                stats.fallbacks++;
+            return p;
+        }
+    }
+#else
+    (void)mode;
+#endif
+    void* p = malloc(bytes == 0 ? 1 : bytes);
+    if (!p)
+        throw bad_alloc();
+    return p;
+}
+
+void huge_free(void* p, size_t bytes) {
+    if (!p)
+        return;
+#ifdef __linux__
+    if (bytes >= HUGE_PAGE_SIZE) {
+        Mapping m = {nullptr, 0};
+        {
+            lock_guard<mutex> lock(registry_mutex);
+            auto it = registry.find(p);
+            if (it != registry.end()) {
+                m = it->second;
+                registry.erase(it);
+            }
+        }
+        if (m.base) {
+            munmap(m.base, m.length);
+            return;
+        }
+    }
+#else
+    (void)bytes;
+#endif
+    free(p);
+}
@@ -0,0 +1,66 @@
+#ifndef HUGE_PAGES_H
+#define HUGE_PAGES_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+using namespace std;
+
+const size_t HUGE_PAGE_SIZE = 2 << 20;
+
+enum HugePageMode {
+    HUGE_OFF,     // plain heap allocations
+    HUGE_THP,     // 2 MB aligned mappings with madvise(MADV_HUGEPAGE)
+    HUGE_EXPLICIT // MAP_HUGETLB from the reserved pool, THP as fallback
+};
+
+// Process-wide policy for allocations made through HugePageAllocator.
+void set_huge_page_mode(HugePageMode mode);
+HugePageMode huge_page_mode();
+
+// Parses "off", "thp" or "explicit". Returns false otherwise.
+bool parse_huge_page_mode(const char* name, HugePageMode& mode);
+const char* huge_page_mode_name(HugePageMode mode);
+
+// Bytes handed out per backing since startup. Arrays smaller than one huge
+// page always come from the heap and are not counted.
+struct HugePageStats {
+    uint64_t explicit_bytes = 0;
+    uint64_t thp_bytes = 0;
+    uint64_t fallbacks = 0; // explicit requests served by THP instead
+};
+HugePageStats huge_page_stats();
+
+void* huge_alloc(size_t bytes);
+void huge_free(void* p, size_t bytes);
+
+// Allocator for large flat arrays (distances, work arrays, CSR graphs) that
+// are accessed randomly and suffer from dTLB misses.
+template <class T> struct HugePageAllocator {
+    using value_type = T;
+
+    HugePageAllocator() = default;
+    template <class U> HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t count) {
+        if (count > SIZE_MAX / sizeof(T))
+            throw bad_alloc();
+        return static_cast<T*>(huge_alloc(count * sizeof(T)));
+    }
+    void deallocate(T* p, size_t count) { huge_free(p, count * sizeof(T)); }
+};
+
+template <class T, class U>
+bool operator==(const HugePageAllocator<T>&, const HugePageAllocator<U>&) {
+    return true;
+}
+template <class T, class U>
+bool operator!=(const HugePageAllocator<T>&, const HugePageAllocator<U>&) {
+    return false;
+}
+
+template <class T> using HugeVector = vector<T, HugePageAllocator<T>>;
+
+#endif // HUGE_PAGES_H
@@ -0,0 +1,74 @@
+#include "landmarks.h"
+#include "bmssp.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+static const double INF = numeric_limits<double>::infinity();
+
+// The tables hold rounded path sums, so a difference of two entries can
+// exceed the true distance by a few ulps. Each difference gives up this
+// fraction of its larger operand to stay admissible.
+static const double SLACK = 1e-9;
+
+double Landmarks::lower_bound(vertex_t v, vertex_t target) const {
+    double h = 0;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        // d(v, L) - d(target, L) <= d(v, target)
+        double tv = to[i][v], tt = to[i][target];
+        if (tt != INF) {
+            if (tv == INF)
+                return INF; // target reaches L but v does not
+            h = max(h, tv - tt - SLACK * tv);
+        }
+        // d(L, target) - d(L, v) <= d(v, target)
+        double fv = from[i][v], ft = from[i][target];
+        if (fv != INF) {
+            if (ft == INF)
+                return INF; // L reaches v but not target
+            h = max(h, ft - fv - SLACK * ft);
+        }
+    }
+    return h;
+}
+
+Landmarks select_landmarks(vertex_t n, const vector<vector<Edge>>& adj,
+                           const vector<vector<Edge>>& radj, int count,
+                           vertex_t first) {
+    Landmarks lm;
+    if (n == 0)
+        return lm;
+    count = min(count, n);
+
+    // Distance of each node to the nearest landmark in either direction;
+    // the next landmark is the node farthest from all chosen ones. Nodes
+    // not connected to any landmark are preferred so every component gets
+    // covered.
+    vector<double> nearest(n, INF);
+    vector<char> chosen(n, 0);
+    int next = first;
+
+    while ((int)lm.ids.size() < count) {
+        chosen[next] = 1;
+        lm.ids.push_back(next);
+        lm.from.push_back(solve_sssp(n, adj, next));
+        lm.to.push_back(solve_sssp(n, radj, next));
+
+        const auto& f = lm.from.back();
+        const auto& t = lm.to.back();
+        for (int v = 0; v < n; ++v)
+            nearest[v] = min(nearest[v], min(f[v], t[v]));
+
+        next = -1;
+        for (int v = 0; v < n; ++v) {
+            if (chosen[v])
+                continue;
+            if (next == -1 || nearest[v] > nearest[next])
+                next = v;
+        }
+        if (next == -1)
+            break;
+    }
+    return lm;
+}
@@ -0,0 +1,30 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Landmark distance tables for ALT (A*, landmarks, triangle inequality)
+// lower bounds on point-to-point distances.
+struct Landmarks {
+    vector<vertex_t> ids;
+    vector<vector<double>> from; // from[i][v] = d(ids[i], v)
+    vector<vector<double>> to;   // to[i][v] = d(v, ids[i])
+
+    // Admissible lower bound on d(v, target). Returns infinity when the
+    // tables prove that target is unreachable from v.
+    double lower_bound(vertex_t v, vertex_t target) const;
+
+    bool empty() const { return ids.empty(); }
+};
+
+// Picks `count` landmarks by farthest-point selection, starting from
+// `first`, and fills both tables with the BMSSP solver on adj and its
+// transpose radj.
+Landmarks select_landmarks(vertex_t n, const vector<vector<Edge>>& adj,
+                           const vector<vector<Edge>>& radj, int count,
+                           vertex_t first = 0);
+
+#endif // LANDMARKS_H
@@ -1,83 +1,789 @@
 #include "bmssp.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "dist_codec.h"
+#include "graph_io.h"
+#include "huge_pages.h"
+#include "landmarks.h"
+#include "numa_policy.h"
+#include "parallel.h"
+#include "partition.h"
+#include "snapshot.h"
+#include "turn_graph.h"
+#include "sssp_cache.h"
 #include "types.h"
+#include "zero_weight.h"
+#include <algorithm>
 #include <chrono>
-#include <cstdio>
+#include <cmath>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <iostream>
 #include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
 using namespace std;
 
+static void print_distances(const vector<double>& results) {
+    cout << "--------------------" << endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        cout << "Node " << i << ": ";
+        if (results[i] == numeric_limits<double>::infinity())
+            cout << "INF";
+        else
+            cout << results[i];
+        cout << endl;
+    }
+}
+
+// Placement summary for --huge-pages, printed once the solve is done.
+static void print_huge_page_report() {
+    HugePageMode mode = huge_page_mode();
+    if (mode == HUGE_OFF)
+        return;
+    HugePageStats stats = huge_page_stats();
+    cout << "Huge pages: " << huge_page_mode_name(mode) << ", "
+         << (stats.explicit_bytes >> 20) << " MB explicit, "
+         << (stats.thp_bytes >> 20) << " MB transparent";
+    if (stats.fallbacks > 0)
+        cout << ", " << stats.fallbacks << " explicit requests fell back";
+    cout << endl;
+}
+
+// Deadline for --time-limit, counted from the start of the solve.
+static chrono::steady_clock::time_point deadline_after(double ms) {
+    if (!(ms > 0))
+        return chrono::steady_clock::time_point::max();
+    return chrono::steady_clock::now() +
+           chrono::duration_cast<chrono::steady_clock::duration>(
+               chrono::duration<double, milli>(ms));
+}
+
+static void print_target(vertex_t target, double dist) {
+    cout << "Node " << target << ": ";
+    if (dist == numeric_limits<double>::infinity())
+        cout << "INF";
+    else
+        cout << dist;
+    cout << endl;
+}
+
+// Repeated-query mode: each line of the query file is `source [bound]`.
+// Results are served through an LRU cache keyed by the graph fingerprint.
+// Queries run on `threads` workers (0 = default_thread_count()) in waves of
+// one query per worker, so only that many results are held at once, and
+// are printed in file order.
+static int run_queries(vertex_t n, const vector<vector<Edge>>& adj,
+                       const char* query_path, size_t cache_bytes,
+                       double resolution, int threads, bool quiet) {
+    ifstream in(query_path);
+    if (!in) {
+        cerr << "Cannot open query file: " << query_path << endl;
+        return 1;
+    }
+
+    struct Query {
+        int id;
+        vertex_t source;
+        double bound;
+    };
+    vector<Query> queries;
+    string line;
+    int query_id = 0;
+    while (getline(in, line)) {
+        istringstream ls(line);
+        if ((ls >> ws).eof())
+            continue; // blank line
+        // A failed extraction would leave a bound of 0, so the bound is
+        // parsed as a token and the whole line must be consumed.
+        vertex_t source;
+        double bound = numeric_limits<double>::infinity();
+        string token;
+        bool ok = static_cast<bool>(ls >> source);
+        if (ok && (ls >> token)) {
+            char* end = nullptr;
+            bound = strtod(token.c_str(), &end);
+            ok = end != token.c_str() && *end == '\0' && !isnan(bound) &&
+                 !(ls >> token);
+        }
+        if (!ok)
+            cerr << "Query " << query_id << ": malformed line \"" << line
+                 << "\"" << endl;
+        else if (source < 0 || source >= n)
+            cerr << "Query " << query_id << ": source out of range" << endl;
+        else
+            queries.push_back({query_id, source, bound});
+        query_id++;
+    }
+
+    SsspCache cache(cache_bytes, resolution);
+    uint64_t fingerprint = graph_fingerprint(n, adj);
+    if (threads <= 0)
+        threads = default_thread_count();
+    vector<vector<double>> results(threads);
+    vector<double> times(threads);
+    vector<char> hits(threads);
+    auto total_start = chrono::high_resolution_clock::now();
+
+    for (size_t begin = 0; begin < queries.size(); begin += threads) {
+        int count = (int)min<size_t>(threads, queries.size() - begin);
+        parallel_for(count, count, [&](int, int i) {
+            const Query& q = queries[begin + i];
+            bool hit = false;
+            auto start_time = chrono::high_resolution_clock::now();
+            results[i] =
+                cache.solve(n, adj, fingerprint, q.source, q.bound, &hit);
+            auto end_time = chrono::high_resolution_clock::now();
+            times[i] = chrono::duration_cast<chrono::microseconds>(
+                           end_time - start_time)
+                           .count() /
+                       1000.0;
+            hits[i] = hit;
+        });
+        for (int i = 0; i < count; ++i) {
+            const Query& q = queries[begin + i];
+            cout << "Query " << q.id << " (source " << q.source << ", "
+                 << (hits[i] ? "hit" : "miss") << ") Time: " << times[i]
+                 << " ms" << endl;
+            if (!quiet)
+                print_distances(results[i]);
+        }
+    }
+
+    auto total_end = chrono::high_resolution_clock::now();
+    auto total =
+        chrono::duration_cast<chrono::microseconds>(total_end - total_start);
+    cout << "BMSSP Time: " << total.count() / 1000.0 << " ms (" << threads
+         << " workers)" << endl;
+    print_huge_page_report();
+    cout << "Cache: " << cache.stats.hits << " hits, " << cache.stats.misses
+         << " misses, " << cache.stats.evictions << " evictions, "
+         << cache.size() << " entries, " << cache.used_bytes << " bytes"
+         << endl;
+    return 0;
+}
+
+// Reads node ids (whitespace separated) into a bitmap over n nodes.
+static bool read_category(const char* path, vertex_t n,
+                          vector<uint64_t>& bits) {
+    ifstream in(path);
+    if (!in)
+        return false;
+    bits.assign((n + 63) / 64, 0);
+    long long v;
+    while (in >> v) {
+        if (v < 0 || v >= n)
+            return false;
+        bits[v >> 6] |= 1ULL << (v & 63);
+    }
+    return in.eof();
+}
+
+static void print_nearest(const vector<Neighbor>& nearest) {
+    cout << "--------------------" << endl;
+    for (const auto& x : nearest)
+        cout << "Node " << x.node << ": " << x.dist << endl;
+}
+
+// Turn-restricted mode: solve on the edge-based expansion and map the
+// result back to vertices. `graph_built` runs once the expansion exists.
+static int run_turn_restricted(vertex_t n, const vector<vector<Edge>>& adj,
+                               vertex_t source, const char* turns_path,
+                               double u_turn_penalty,
+                               const function<void()>& graph_built,
+                               bool quiet) {
+    vector<TurnCost> turns;
+    if (!read_turn_costs(turns_path, turns)) {
+        cerr << "Cannot read turn costs from " << turns_path << endl;
+        return 1;
+    }
+
+    auto pre_start = chrono::high_resolution_clock::now();
+    EdgeBasedGraph eg;
+    try {
+        eg = build_edge_based(n, adj, turns, u_turn_penalty);
+    } catch (const overflow_error& e) {
+        cerr << "Cannot expand graph for turn costs: " << e.what() << endl;
+        return 1;
+    }
+    auto pre_end = chrono::high_resolution_clock::now();
+    auto pre =
+        chrono::duration_cast<chrono::microseconds>(pre_end - pre_start);
+    cout << "Expansion Time: " << pre.count() / 1000.0 << " ms ("
+         << eg.graph.n << " edge-based nodes)" << endl;
+    graph_built();
+
+    auto start_time = chrono::high_resolution_clock::now();
+    vector<double> edge_dist =
+        solve_sssp(eg.graph.view(), eg.entry_node(source));
+    vector<double> results = vertex_distances(eg, source, edge_dist);
+    auto end_time = chrono::high_resolution_clock::now();
+    auto duration =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+    cout << "BMSSP Time: " << duration.count() / 1000.0 << " ms" << endl;
+    print_huge_page_report();
+
+    if (!quiet)
+        print_distances(results);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
     bool quiet = false;
     bool binary = false;
+    const char* query_path = nullptr;
+    size_t cache_mb = 256;
+    double resolution = 1e-6;
+    const char* dist_out = nullptr;
+    vertex_t target = -1;
+    int landmark_count = 0;
+    bool bidir = false;
+    bool reverse = false;
+    const char* turns_path = nullptr;
+    double u_turn_penalty = 0;
+    int partition_parts = 0;
+    NumaMode numa = NUMA_DEFAULT;
+    bool pin_threads = false;
+    HugePageMode huge_pages = HUGE_OFF;
+    int prefetch_distance = 0;
+    bool compress = false;
+    int threads = 0;
+    const char* pred_out = nullptr;
+    double weight_resolution = 0;
+    bool strict = false;
+    bool contract_zero = false;
+    int build_threads = -1;
+    bool sort_rows = false;
+    const char* snapshot_path = nullptr;
+    const char* save_snapshot_path = nullptr;
+    bool verify_snapshot = true;
+    double time_limit_ms = 0;
+    int nearest = 0;
+    const char* category_path = nullptr;
     for (int i = 1; i < argc; ++i) {
         if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
             quiet = true;
         else if (strcmp(argv[i], "-b") == 0 || strcmp(argv[i], "--binary") == 0)
             binary = true;
+        else if (strcmp(argv[i], "--queries") == 0 && i + 1 < argc)
+            query_path = argv[++i];
+        else if (strcmp(argv[i], "--cache-mb") == 0 && i + 1 < argc)
+            cache_mb = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--resolution") == 0 && i + 1 < argc)
+            resolution = atof(argv[++i]);
+        else if (strcmp(argv[i], "--dist-out") == 0 && i + 1 < argc)
+            dist_out = argv[++i];
+        else if (strcmp(argv[i], "--target") == 0 && i + 1 < argc)
+            target = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--landmarks") == 0 && i + 1 < argc)
+            landmark_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--bidir") == 0)
+            bidir = true;
+        else if (strcmp(argv[i], "--reverse") == 0)
+            reverse = true;
+        else if (strcmp(argv[i], "--turns") == 0 && i + 1 < argc)
+            turns_path = argv[++i];
+        else if (strcmp(argv[i], "--u-turn-penalty") == 0 && i + 1 < argc)
+            u_turn_penalty = atof(argv[++i]);
+        else if (strcmp(argv[i], "--partition") == 0 && i + 1 < argc)
+            partition_parts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--numa") == 0 && i + 1 < argc) {
+            if (!parse_numa_mode(argv[++i], numa)) {
+                cerr << "Unknown NUMA mode: " << argv[i] << endl;
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--pin-threads") == 0) {
+            pin_threads = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pred-out") == 0 && i + 1 < argc) {
+            pred_out = argv[++i];
+        } else if (strcmp(argv[i], "--strict") == 0) {
+            strict = true;
+        } else if (strcmp(argv[i], "--contract-zero") == 0) {
+            contract_zero = true;
+        } else if (strcmp(argv[i], "--build-threads") == 0 && i + 1 < argc) {
+            build_threads = max(0, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--sort-rows") == 0) {
+            sort_rows = true;
+        } else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+        } else if (strcmp(argv[i], "--save-snapshot") == 0 && i + 1 < argc) {
+            save_snapshot_path = argv[++i];
+        } else if (strcmp(argv[i], "--nearest") == 0 && i + 1 < argc) {
+            nearest = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--category") == 0 && i + 1 < argc) {
+            category_path = argv[++i];
+        } else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) {
+            time_limit_ms = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--no-verify") == 0) {
+            verify_snapshot = false;
+        } else if (strcmp(argv[i], "--compress") == 0) {
+            compress = true;
+        } else if (strcmp(argv[i], "--weight-resolution") == 0 &&
+                   i + 1 < argc) {
+            weight_resolution = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--prefetch") == 0 && i + 1 < argc) {
+            prefetch_distance = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--huge-pages") == 0 && i + 1 < argc) {
+            if (!parse_huge_page_mode(argv[++i], huge_pages)) {
+                cerr << "Unknown huge page mode: " << argv[i] << endl;
+                return 1;
+            }
+        }
     }
+    set_huge_page_mode(huge_pages);
 
-    int n, m, source;
-    vector<vector<Edge>> adj;
-
-    if (binary) {
-        int32_t header[3];
-        if (fread(header, sizeof(int32_t), 3, stdin) != 3)
-            return 0;
-        n = header[0];
-        m = header[1];
-        source = header[2];
-        adj.resize(n);
-
-        struct BinaryEdge {
-            int32_t u, v;
-            double w;
-        };
-        vector<BinaryEdge> edges(m);
-        if (fread(edges.data(), sizeof(BinaryEdge), m, stdin) != (size_t)m)
+    if (!(resolution > 0)) {
+        cerr << "--resolution must be positive" << endl;
+        return 1;
+    }
+
+    // --build-threads skips adjacency lists and builds the CSR arrays from
+    // the edge list in parallel; the modes that need adj are out then.
+    bool csr_build = build_threads >= 0;
+    if (csr_build && (query_path || turns_path || target >= 0 || reverse ||
+                      partition_parts > 0 || compress || contract_zero)) {
+        cerr << "--build-threads only supports single-source solves" << endl;
+        return 1;
+    }
+    if (nearest > 0 && (query_path || turns_path || target >= 0 ||
+                        partition_parts > 0 || compress || contract_zero)) {
+        cerr << "--nearest only supports plain single-source graphs" << endl;
+        return 1;
+    }
+    // The bidirectional, batch, turn-restricted and snapshot-writing modes
+    // run without a stop source.
+    if (time_limit_ms > 0 && ((bidir && target >= 0) || query_path ||
+                              turns_path || save_snapshot_path)) {
+        cerr << "--time-limit only supports single-source, target and "
+                "--nearest solves"
+             << endl;
+        return 1;
+    }
+    if (category_path && nearest <= 0) {
+        cerr << "--category requires --nearest" << endl;
+        return 1;
+    }
+    if (sort_rows && !csr_build) {
+        cerr << "--sort-rows requires --build-threads" << endl;
+        return 1;
+    }
+
+    // A snapshot replaces stdin. Plain single-source solves (and target
+    // solves whose landmarks are in the snapshot) run on the mapped CSR
+    // arrays in place; the other modes copy them into adjacency lists.
+    MappedSnapshot snapshot;
+    if (snapshot_path) {
+        string error;
+        if (csr_build || save_snapshot_path) {
+            cerr << "--snapshot cannot be combined with --build-threads or "
+                    "--save-snapshot"
+                 << endl;
             return 1;
-        for (int i = 0; i < m; ++i) {
-            if (edges[i].u < n && edges[i].v < n)
-                adj[edges[i].u].push_back({edges[i].v, edges[i].w});
+        }
+        if (!snapshot.open(snapshot_path, error, verify_snapshot)) {
+            cerr << "Cannot open snapshot: " << error << endl;
+            return 1;
+        }
+    }
+    Landmarks stored_landmarks;
+    bool has_snapshot_landmarks = snapshot_path && target >= 0 &&
+                                  landmark_count > 0 &&
+                                  snapshot.landmarks(stored_landmarks);
+    bool snapshot_direct =
+        snapshot_path && !query_path && !turns_path && !reverse && !bidir &&
+        partition_parts == 0 && !compress && !contract_zero &&
+        (target < 0 || landmark_count == 0 || has_snapshot_landmarks);
+    if (save_snapshot_path && csr_build && landmark_count > 0) {
+        cerr << "--save-snapshot with --landmarks needs adjacency lists "
+                "(drop --build-threads)"
+             << endl;
+        return 1;
+    }
+
+    // The transposed graph is built during loading when a mode needs it.
+    bool with_reverse =
+        reverse || (target >= 0 && (bidir || landmark_count > 0)) ||
+        (save_snapshot_path && !csr_build);
+    // The placement policy covers every graph layout built before the solve
+    // (loading, relabeling, compression and CSR copies); search state is
+    // then placed by first touch. Pinning applies to every parallel phase.
+    bool numa_applied = numa == NUMA_DEFAULT || set_numa_mode(numa);
+    auto end_graph_placement = [&]() {
+        if (numa != NUMA_DEFAULT && numa_applied)
+            set_numa_mode(NUMA_DEFAULT);
+    };
+    set_thread_pinning(pin_threads);
+    GraphInput g;
+    CsrGraph csr;
+    CsrView graph_view;
+    LoadStatus status = LOAD_OK;
+    if (snapshot_direct) {
+        if (!snapshot.graph("graph", graph_view)) {
+            cerr << "Cannot load snapshot: no valid graph sections" << endl;
+            return 1;
+        }
+        g.n = graph_view.n;
+        g.m = graph_view.edge_count();
+        g.source = snapshot.header.source;
+    } else if (snapshot_path) {
+        string error;
+        if (!load_snapshot_graph(snapshot, with_reverse, g, error)) {
+            cerr << "Cannot load snapshot: " << error << endl;
+            return 1;
+        }
+    } else if (csr_build) {
+        vector<BinaryEdge> edge_list;
+        status = load_edges(binary, g, edge_list);
+        if (status == LOAD_OK) {
+            auto pre_start = chrono::high_resolution_clock::now();
+            csr = build_csr(g.n, edge_list, build_threads, sort_rows);
+            auto pre_end = chrono::high_resolution_clock::now();
+            auto pre = chrono::duration_cast<chrono::microseconds>(pre_end -
+                                                                   pre_start);
+            cout << "Build Time: " << pre.count() / 1000.0 << " ms ("
+                 << (build_threads > 0 ? build_threads
+                                       : default_thread_count())
+                 << " threads)" << endl;
+            graph_view = csr.view();
         }
     } else {
-        if (!(cin >> n >> m))
-            return 0;
-        adj.resize(n);
-        for (int i = 0; i < m; ++i) {
-            int u, v;
-            double w;
-            cin >> u >> v >> w;
-            if (u < n && v < n)
-                adj[u].push_back({v, w});
+        status = load_graph(binary, with_reverse, g);
+    }
+    if (numa != NUMA_DEFAULT || pin_threads)
+        cout << describe_placement(numa, numa_applied, pin_threads) << endl;
+    if (status == LOAD_EMPTY)
+        return 0;
+    if (status != LOAD_OK) {
+        report_load_error(status, g);
+        return 1;
+    }
+    vertex_t n = g.n;
+    vertex_t source = g.source;
+    vertex_t input_n = n;
+
+    if (save_snapshot_path) {
+        auto pre_start = chrono::high_resolution_clock::now();
+        SnapshotWriter writer;
+        writer.n = n;
+        writer.m = csr_build ? csr.view().edge_count() : g.m;
+        writer.source = source;
+        CsrGraph forward, backward;
+        Landmarks landmarks;
+        if (csr_build) {
+            writer.add_graph("graph", csr.view());
+        } else {
+            forward = build_csr(n, g.adj);
+            backward = build_csr(n, g.radj);
+            writer.m = forward.view().edge_count();
+            writer.add_graph("graph", forward.view());
+            writer.add_graph("reverse", backward.view());
+            if (landmark_count > 0) {
+                landmarks = select_landmarks(n, g.adj, g.radj, landmark_count);
+                writer.add_landmarks(landmarks);
+            }
+        }
+        string error;
+        if (!writer.write(save_snapshot_path, error)) {
+            cerr << "Cannot write snapshot: " << error << endl;
+            return 1;
+        }
+        auto pre_end = chrono::high_resolution_clock::now();
+        auto pre = chrono::duration_cast<chrono::microseconds>(pre_end -
+                                                               pre_start);
+        cout << "Snapshot Time: " << pre.count() / 1000.0 << " ms ("
+             << writer.pending.size() << " sections, " << landmarks.ids.size()
+             << " landmarks)" << endl;
+        return 0;
+    }
+
+    // Zero-weight contraction solves on the quotient graph of zero-weight
+    // cycles; distances are expanded back to input nodes at the end.
+    // Predecessors are then recomputed on the input graph, which is kept
+    // only for that.
+    ZeroContraction zc;
+    vector<vector<Edge>> input_adj;
+    if (contract_zero && n > 0) {
+        if (turns_path || query_path) {
+            cerr << "--contract-zero only supports single-source and target "
+                    "solves"
+                 << endl;
+            return 1;
+        }
+        auto pre_start = chrono::high_resolution_clock::now();
+        vector<vector<Edge>>& fwd = reverse ? g.radj : g.adj;
+        vector<vector<Edge>>& bwd = reverse ? g.adj : g.radj;
+        zc = contract_zero_cycles(n, fwd);
+        auto pre_end = chrono::high_resolution_clock::now();
+        auto pre = chrono::duration_cast<chrono::microseconds>(pre_end -
+                                                               pre_start);
+        cout << "Contraction Time: " << pre.count() / 1000.0 << " ms ("
+             << zc.components << " of " << n << " nodes left)" << endl;
+        if (zc.components == n) {
+            zc = ZeroContraction();
+        } else {
+            if (with_reverse)
+                bwd = contract_graph(bwd, zc.comp, zc.components);
+            if (pred_out)
+                input_adj.swap(fwd);
+            fwd.swap(zc.adj);
+            vector<vector<Edge>>().swap(zc.adj);
+            n = zc.components;
+            if (source >= 0 && source < input_n)
+                source = zc.comp[source];
         }
-        cin >> source;
     }
+    bool contracted = !zc.comp.empty();
+
+    // Reverse mode answers every query on the transposed graph: distances
+    // from all nodes to `source` (or from `target` to `source`).
+    vector<vector<Edge>>* adj_ptr = reverse ? &g.radj : &g.adj;
+    vector<vector<Edge>>* radj_ptr = reverse ? &g.adj : &g.radj;
+
+    // Partition mode relabels the graph so each part is a contiguous id
+    // range, solves on the relabeled graph and maps results back.
+    Partition layout;
+    if (partition_parts > 0 && n > 0) {
+        auto pre_start = chrono::high_resolution_clock::now();
+        layout = partition_graph(n, *adj_ptr, partition_parts);
+        *adj_ptr = permute_graph(*adj_ptr, layout.new_id);
+        if (with_reverse)
+            *radj_ptr = permute_graph(*radj_ptr, layout.new_id);
+        auto pre_end = chrono::high_resolution_clock::now();
+        auto pre = chrono::duration_cast<chrono::microseconds>(pre_end -
+                                                               pre_start);
+        cout << "Partition Time: " << pre.count() / 1000.0 << " ms ("
+             << layout.parts << " parts, " << layout.cut_edges
+             << " cut edges)" << endl;
+        if (source >= 0 && source < n)
+            source = layout.new_id[source];
+    }
+    const vector<vector<Edge>>& adj = *adj_ptr;
+    const vector<vector<Edge>>& radj = *radj_ptr;
+    bool relabeled = !layout.new_id.empty();
+
+    if (relabeled && (turns_path || query_path)) {
+        cerr << "--partition only supports single-source and target solves"
+             << endl;
+        return 1;
+    }
+
+    if (turns_path) {
+        if (query_path || target >= 0 || reverse) {
+            cerr << "--turns only supports single-source solves" << endl;
+            return 1;
+        }
+        return run_turn_restricted(n, adj, source, turns_path,
+                                   u_turn_penalty, end_graph_placement,
+                                   quiet);
+    }
+
+    if (query_path) {
+        end_graph_placement();
+        return run_queries(n, adj, query_path, cache_mb << 20, resolution,
+                           threads, quiet);
+    }
+
+    if (target >= input_n) {
+        cerr << "Target out of range" << endl;
+        return 1;
+    }
+    vertex_t solve_target =
+        target >= 0 && contracted ? zc.comp[target] : target;
+    if (solve_target >= 0 && relabeled)
+        solve_target = layout.new_id[solve_target];
 
+    if (target >= 0 && bidir) {
+        end_graph_placement();
+        int rounds = 0;
+        auto start_time = chrono::high_resolution_clock::now();
+        double d =
+            bidirectional_bmssp(n, adj, radj, source, solve_target, &rounds);
+        auto end_time = chrono::high_resolution_clock::now();
+        auto duration =
+            chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        cout << "BMSSP Time: " << duration.count() / 1000.0 << " ms ("
+             << rounds << " rounds)" << endl;
+        print_huge_page_report();
+        if (!quiet)
+            print_target(target, d);
+        return 0;
+    }
+
+    SsspOptions opts;
+    opts.prefetch_distance = prefetch_distance;
+    opts.threads = threads;
+    opts.strict = strict;
+
+    if (nearest > 0) {
+        vector<uint64_t> category;
+        if (category_path && !read_category(category_path, n, category)) {
+            cerr << "Cannot read node ids from " << category_path << endl;
+            return 1;
+        }
+        const uint64_t* bits = category_path ? category.data() : nullptr;
+        end_graph_placement();
+        SolveStatus nearest_status;
+        opts.status = &nearest_status;
+        opts.deadline = deadline_after(time_limit_ms);
+        int rounds = 0;
+        auto start_time = chrono::high_resolution_clock::now();
+        vector<Neighbor> found =
+            csr_build || snapshot_direct
+                ? nearest_k(graph_view, source, nearest, bits, opts, &rounds)
+                : nearest_k(n, adj, source, nearest, bits, opts, &rounds);
+        auto end_time = chrono::high_resolution_clock::now();
+        auto duration =
+            chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        cout << "BMSSP Time: " << duration.count() / 1000.0 << " ms ("
+             << rounds << " rounds, " << found.size() << " found)" << endl;
+        if (nearest_status == SOLVE_DEADLINE)
+            cout << "Time limit reached: " << found.size() << " of " << nearest
+                 << " neighbors proven" << endl;
+        if (!quiet)
+            print_nearest(found);
+        return 0;
+    }
+    vector<vertex_t> parents;
+    if (pred_out && !contracted)
+        opts.parents = &parents;
+    Landmarks landmarks;
+    if (has_snapshot_landmarks && !relabeled && !contracted && !reverse) {
+        landmarks = move(stored_landmarks);
+        cout << "Landmarks: " << landmarks.ids.size() << " from snapshot"
+             << endl;
+        opts.target = solve_target;
+        opts.landmarks = &landmarks;
+    } else if (target >= 0 && landmark_count > 0) {
+        auto pre_start = chrono::high_resolution_clock::now();
+        landmarks = select_landmarks(n, adj, radj, landmark_count);
+        auto pre_end = chrono::high_resolution_clock::now();
+        auto pre = chrono::duration_cast<chrono::microseconds>(pre_end -
+                                                               pre_start);
+        cout << "Preprocessing Time: " << pre.count() / 1000.0 << " ms ("
+             << landmarks.ids.size() << " landmarks)" << endl;
+        opts.target = solve_target;
+        opts.landmarks = &landmarks;
+    }
+
+    // Under a huge page policy the graph moves into flat CSR arrays that the
+    // policy can back; adjacency lists are many small heap blocks.
+    // --compress stores it gap-encoded instead, decoded during relaxation.
+    CompressedGraph packed;
+    if (compress) {
+        packed = compress_graph(n, adj, weight_resolution);
+        size_t csr_bytes = (n + 1) * sizeof(edge_t) +
+                           packed.m * (sizeof(vertex_t) + sizeof(double));
+        cout << "Compressed graph: " << packed.bytes() << " bytes ("
+             << csr_bytes << " CSR), weight resolution " << packed.scale
+             << endl;
+        if (packed.max_relative_error > 0)
+            cerr << "Warning: --compress rounds edge weights to multiples of "
+                 << packed.scale << " (relative error up to "
+                 << packed.max_relative_error
+                 << "); distances are exact for the rounded weights" << endl;
+    } else if (huge_pages != HUGE_OFF && !csr_build && !snapshot_direct) {
+        csr = build_csr(n, adj);
+        graph_view = csr.view();
+    }
+    if (compress || huge_pages != HUGE_OFF) {
+        vector<vector<Edge>>().swap(*adj_ptr);
+        vector<vector<Edge>>().swap(*radj_ptr);
+    }
+    end_graph_placement();
+
+    SolveStatus solve_status;
+    opts.status = &solve_status;
+    opts.deadline = deadline_after(time_limit_ms);
     auto start_time = chrono::high_resolution_clock::now();
-    vector<double> results = solve_sssp(n, adj, source);
+    vector<double> results;
+    if (compress)
+        results = solve_sssp(packed.view(), source, opts);
+    else if (huge_pages != HUGE_OFF || csr_build || snapshot_direct)
+        results = solve_sssp(graph_view, source, opts);
+    else
+        results = solve_sssp(n, adj, source, opts);
     auto end_time = chrono::high_resolution_clock::now();
 
     auto duration =
         chrono::duration_cast<chrono::microseconds>(end_time - start_time);
     cout << "BMSSP Time: " << duration.count() / 1000.0 << " ms" << endl;
+    if (solve_status == SOLVE_DEADLINE)
+        cout << "Time limit reached: "
+             << count_if(results.begin(), results.end(),
+                         [](double d) {
+                             return d != numeric_limits<double>::infinity();
+                         })
+             << " of " << n << " distances proven" << endl;
+    print_huge_page_report();
+
+    if (target >= 0) {
+        if (!quiet)
+            print_target(target, results[solve_target]);
+        return 0;
+    }
 
-    if (!quiet) {
-        cout << "--------------------" << endl;
-        for (int i = 0; i < n; ++i) {
-            cout << "Node " << i << ": ";
-            if (results[i] == numeric_limits<double>::infinity())
-                cout << "INF";
-            else
-                cout << results[i];
-            cout << endl;
+    if (relabeled) {
+        vector<double> original(n);
+        for (int v = 0; v < n; ++v)
+            original[v] = results[layout.new_id[v]];
+        results.swap(original);
+        if (pred_out && !contracted) {
+            vector<vertex_t> original_parents(n);
+            for (int v = 0; v < n; ++v) {
+                int p = parents[layout.new_id[v]];
+                original_parents[v] = p < 0 ? -1 : layout.order[p];
+            }
+            parents.swap(original_parents);
         }
     }
 
+    if (contracted) {
+        results = expand_distances(zc.comp, results);
+        if (pred_out)
+            parents = tight_parents(input_adj, g.source, results);
+    }
+
+    if (pred_out) {
+        ofstream out(pred_out);
+        for (vertex_t p : parents)
+            out << p << '\n';
+        if (!out) {
+            cerr << "Cannot write predecessors to " << pred_out << endl;
+            return 1;
+        }
+    }
+
+    if (dist_out) {
+        CompressedDistances encoded;
+        try {
+            encoded = CompressedDistances(results, resolution);
+        } catch (const overflow_error& e) {
+            cerr << "Cannot encode distances: " << e.what()
+                 << " (raise --resolution)" << endl;
+            return 1;
+        }
+        ofstream out(dist_out, ios::binary);
+        if (!encoded.write(out)) {
+            cerr << "Cannot write distances to " << dist_out << endl;
+            return 1;
+        }
+        cout << "Compressed distances: " << encoded.bytes() << " bytes ("
+             << results.size() * sizeof(double) << " dense)" << endl;
+    }
+
+    if (!quiet)
+        print_distances(results);
+
     return 0;
 }
@@ -0,0 +1,94 @@
+#include "many_to_many.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace {
+
+struct BucketEntry {
+    int node;
+    int col;
+    double dist;
+};
+
+} // namespace
+
+DistanceTable many_to_many(const ContractionHierarchy& ch,
+                           const vector<vertex_t>& origins,
+                           const vector<vertex_t>& destinations, int threads) {
+    DistanceTable table;
+    table.rows = (int)origins.size();
+    table.cols = (int)destinations.size();
+    table.data.assign((size_t)table.rows * table.cols,
+                      numeric_limits<double>::infinity());
+    if (table.rows == 0 || table.cols == 0)
+        return table;
+
+    if (threads <= 0)
+        threads = default_thread_count();
+    // Query state is created by the worker that uses it, so its pages are
+    // first touched on that worker's NUMA node.
+    vector<unique_ptr<ChQuery>> workers(threads);
+
+    // Backward phase: per-thread entry lists, merged into node-indexed
+    // buckets (CSR layout) afterwards.
+    vector<vector<BucketEntry>> local(threads);
+    vector<vector<pair<int, double>>> spaces(threads);
+    parallel_for(table.cols, threads, [&](int w, int j) {
+        if (!workers[w])
+            workers[w].reset(new ChQuery(ch));
+        workers[w]->upward_space(destinations[j], true, spaces[w]);
+        for (const auto& p : spaces[w])
+            local[w].push_back({p.first, j, p.second});
+    });
+
+    vector<size_t> bucket_start(ch.n + 1, 0);
+    for (const auto& entries : local)
+        for (const auto& e : entries)
+            bucket_start[e.node + 1]++;
+    for (int v = 0; v < ch.n; ++v)
+        bucket_start[v + 1] += bucket_start[v];
+    vector<pair<int, double>> buckets(bucket_start[ch.n]);
+    vector<size_t> fill(bucket_start.begin(), bucket_start.end() - 1);
+    for (auto& entries : local) {
+        for (const auto& e : entries)
+            buckets[fill[e.node]++] = {e.col, e.dist};
+        vector<BucketEntry>().swap(entries);
+    }
+
+    // Forward phase: each origin owns its table row, so rows are written
+    // without synchronization.
+    parallel_for(table.rows, threads, [&](int w, int i) {
+        if (!workers[w])
+            workers[w].reset(new ChQuery(ch));
+        workers[w]->upward_space(origins[i], false, spaces[w]);
+        double* row = &table.data[(size_t)i * table.cols];
+        for (const auto& p : spaces[w]) {
+            int v = p.first;
+            for (size_t b = bucket_start[v]; b < bucket_start[v + 1]; ++b) {
+                double d = p.second + buckets[b].second;
+                if (d < row[buckets[b].first])
+                    row[buckets[b].first] = d;
+            }
+        }
+    });
+    return table;
+}
+
+bool write_matrix(const string& path, const DistanceTable& table) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f)
+        return false;
+    const char magic[4] = {'B', 'M', 'T', 'X'};
+    int32_t dims[2] = {table.rows, table.cols};
+    bool ok = fwrite(magic, 1, 4, f) == 4 &&
+              fwrite(dims, sizeof(int32_t), 2, f) == 2 &&
+              fwrite(table.data.data(), sizeof(double), table.data.size(),
+                     f) == table.data.size();
+    return fclose(f) == 0 && ok;
+}
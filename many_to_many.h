@@ -0,0 +1,33 @@
+#ifndef MANY_TO_MANY_H
+#define MANY_TO_MANY_H
+
+#include "ch.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Row-major origin x destination distance table.
+struct DistanceTable {
+    int rows = 0;
+    int cols = 0;
+    vector<double> data;
+
+    double at(int i, int j) const { return data[(size_t)i * cols + j]; }
+};
+
+// Bucket-based many-to-many on a contraction hierarchy. A backward upward
+// search from every destination leaves (destination, distance) entries in
+// buckets at the nodes it settles; a forward upward search from each
+// origin then scans the buckets of its search space. Both phases run in
+// parallel on `threads` workers (0 = hardware concurrency).
+DistanceTable many_to_many(const ContractionHierarchy& ch,
+                           const vector<vertex_t>& origins,
+                           const vector<vertex_t>& destinations,
+                           int threads = 0);
+
+// Binary matrix file: magic "BMTX", int32 rows, int32 cols, then
+// rows * cols float64 values in row-major order (INF when unreachable).
+bool write_matrix(const string& path, const DistanceTable& table);
+
+#endif // MANY_TO_MANY_H
@@ -0,0 +1,97 @@
+#include "numa_policy.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// Mode values from <linux/mempolicy.h>.
+static const int MPOL_DEFAULT_VALUE = 0;
+static const int MPOL_INTERLEAVE_VALUE = 3;
+static const int MPOL_LOCAL_VALUE = 4;
+
+// Online node ids from sysfs, e.g. "0-1" or "0,2-3".
+static vector<int> online_nodes() {
+    vector<int> nodes;
+    ifstream in("/sys/devices/system/node/online");
+    string list;
+    if (!(in >> list))
+        return nodes;
+    stringstream ss(list);
+    string range;
+    while (getline(ss, range, ',')) {
+        size_t dash = range.find('-');
+        int lo = stoi(range.substr(0, dash));
+        int hi = dash == string::npos ? lo : stoi(range.substr(dash + 1));
+        for (int v = lo; v <= hi; ++v)
+            nodes.push_back(v);
+    }
+    return nodes;
+}
+
+int numa_node_count() {
+    size_t count = online_nodes().size();
+    return count == 0 ? 1 : (int)count;
+}
+
+bool parse_numa_mode(const string& name, NumaMode& mode) {
+    if (name == "default")
+        mode = NUMA_DEFAULT;
+    else if (name == "interleave")
+        mode = NUMA_INTERLEAVE;
+    else if (name == "local")
+        mode = NUMA_LOCAL;
+    else
+        return false;
+    return true;
+}
+
+const char* numa_mode_name(NumaMode mode) {
+    switch (mode) {
+    case NUMA_INTERLEAVE:
+        return "interleave";
+    case NUMA_LOCAL:
+        return "local";
+    default:
+        return "default";
+    }
+}
+
+bool set_numa_mode(NumaMode mode) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    const int bits = 8 * sizeof(unsigned long);
+    vector<unsigned long> mask;
+    int policy = MPOL_DEFAULT_VALUE;
+    if (mode == NUMA_INTERLEAVE) {
+        policy = MPOL_INTERLEAVE_VALUE;
+        for (int node : online_nodes()) {
+            if ((size_t)(node / bits) >= mask.size())
+                mask.resize(node / bits + 1, 0);
+            mask[node / bits] |= 1UL << (node % bits);
+        }
+        if (mask.empty())
+            mask.push_back(1);
+    } else if (mode == NUMA_LOCAL) {
+        policy = MPOL_LOCAL_VALUE;
+    }
+    // The kernel reads maxnode - 1 bits of the mask.
+    unsigned long maxnode = mask.empty() ? 0 : mask.size() * bits + 1;
+    return syscall(SYS_set_mempolicy, policy,
+                   mask.empty() ? nullptr : mask.data(), maxnode) == 0;
+#else
+    return mode == NUMA_DEFAULT;
+#endif
+}
+
+string describe_placement(NumaMode mode, bool applied, bool pinned) {
+    ostringstream out;
+    out << "NUMA: " << numa_node_count() << " node(s), memory policy "
+        << numa_mode_name(mode) << (applied ? "" : " (not applied)")
+        << ", threads " << (pinned ? "pinned" : "unpinned");
+    return out.str();
+}
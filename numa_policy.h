@@ -0,0 +1,30 @@
+#ifndef NUMA_POLICY_H
+#define NUMA_POLICY_H
+
+#include <string>
+
+using namespace std;
+
+enum NumaMode {
+    NUMA_DEFAULT,    // first touch: pages land on the allocating thread's node
+    NUMA_INTERLEAVE, // pages spread round-robin over all online nodes
+    NUMA_LOCAL       // pages forced onto the allocating thread's node
+};
+
+// Number of online NUMA nodes (1 when the topology cannot be read).
+int numa_node_count();
+
+// Parses "default", "interleave" or "local". Returns false otherwise.
+bool parse_numa_mode(const string& name, NumaMode& mode);
+
+const char* numa_mode_name(NumaMode mode);
+
+// Sets the memory policy of the calling thread for all later allocations,
+// through the set_mempolicy system call (no libnuma needed). Returns false
+// when the kernel rejects it or the platform has no NUMA support.
+bool set_numa_mode(NumaMode mode);
+
+// One-line summary of the node count and placement policy in effect.
+string describe_placement(NumaMode mode, bool applied, bool pinned);
+
+#endif // NUMA_POLICY_H
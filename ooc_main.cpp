@@ -0,0 +1,139 @@
+#include "bmssp.h"
+#include "csr_file.h"
+#include "external_sssp.h"
+#include "snapshot.h"
+#include "types.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static void print_distances(const vector<double>& results) {
+    cout << "--------------------" << endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        cout << "Node " << i << ": ";
+        if (results[i] == numeric_limits<double>::infinity())
+            cout << "INF";
+        else
+            cout << results[i];
+        cout << endl;
+    }
+}
+
+// External-memory front end. `--convert IN OUT` turns a binary graph file
+// into a CSR file; `--graph FILE` solves on a mapped CSR file.
+int main(int argc, char* argv[]) {
+    ios::sync_with_stdio(false);
+
+    bool quiet = false;
+    const char* convert_in = nullptr;
+    const char* convert_out = nullptr;
+    const char* graph_path = nullptr;
+    const char* snapshot_path = nullptr;
+    vertex_t source = 0;
+    bool source_set = false;
+    ExternalOptions opts;
+    bool in_memory = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0)
+            quiet = true;
+        else if (strcmp(argv[i], "--convert") == 0 && i + 2 < argc) {
+            convert_in = argv[++i];
+            convert_out = argv[++i];
+        } else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc)
+            graph_path = argv[++i];
+        else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc)
+            snapshot_path = argv[++i];
+        else if (strcmp(argv[i], "--source") == 0 && i + 1 < argc) {
+            source = atoi(argv[++i]);
+            source_set = true;
+        }
+        else if (strcmp(argv[i], "--block-nodes") == 0 && i + 1 < argc)
+            opts.block_nodes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--buffer-mb") == 0 && i + 1 < argc)
+            opts.buffer_bytes = strtoull(argv[++i], nullptr, 10) << 20;
+        else if (strcmp(argv[i], "--bmssp") == 0)
+            in_memory = true;
+    }
+
+    if (convert_in) {
+        string error;
+        vertex_t file_source = 0;
+        auto start_time = chrono::high_resolution_clock::now();
+        if (!convert_to_csr_file(convert_in, convert_out, file_source,
+                                 error)) {
+            cerr << "Conversion failed: " << error << endl;
+            return 1;
+        }
+        auto end_time = chrono::high_resolution_clock::now();
+        auto duration =
+            chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+        cout << "Conversion Time: " << duration.count() / 1000.0
+             << " ms (source " << file_source << ")" << endl;
+        return 0;
+    }
+
+    if (!graph_path && !snapshot_path) {
+        cerr << "Usage: ooc_solver --convert IN.bin OUT.csr | --graph FILE.csr"
+                " | --snapshot FILE [--source S]"
+             << endl;
+        return 1;
+    }
+
+    // A snapshot is used in place like a CSR file; its data checksums are
+    // not checked up front, since that would read the whole graph.
+    MappedCsr mapped;
+    MappedSnapshot snapshot;
+    CsrView graph;
+    string error;
+    if (snapshot_path) {
+        if (!snapshot.open(snapshot_path, error, false) ||
+            !snapshot.graph("graph", graph)) {
+            cerr << "Cannot open snapshot: "
+                 << (error.empty() ? "no graph sections" : error) << endl;
+            return 1;
+        }
+        if (!source_set)
+            source = snapshot.header.source;
+    } else {
+        if (!mapped.open(graph_path, error)) {
+            cerr << "Cannot open CSR file: " << error << endl;
+            return 1;
+        }
+        graph = mapped.view;
+    }
+    if (source < 0 || source >= graph.n) {
+        cerr << "Source out of range" << endl;
+        return 1;
+    }
+
+    auto start_time = chrono::high_resolution_clock::now();
+    vector<double> results;
+    BlockBuffer::Stats stats;
+    uint64_t rounds = 0;
+    if (in_memory)
+        results = solve_sssp(graph, source);
+    else
+        results = external_sssp(graph, source, opts, &stats, &rounds);
+    auto end_time = chrono::high_resolution_clock::now();
+    auto duration =
+        chrono::duration_cast<chrono::microseconds>(end_time - start_time);
+
+    if (in_memory) {
+        cout << "BMSSP Time: " << duration.count() / 1000.0 << " ms" << endl;
+    } else {
+        cout << "OOC Time: " << duration.count() / 1000.0 << " ms (" << rounds
+             << " block rounds)" << endl;
+        cout << "Buffer: " << stats.loads << " loads, " << stats.hits
+             << " hits, " << stats.evictions << " evictions, "
+             << (stats.bytes_loaded >> 20) << " MB read" << endl;
+    }
+    if (!quiet)
+        print_distances(results);
+    return 0;
+}
@@ -0,0 +1,266 @@
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static mutex pinning_mutex;
+static ThreadPinning process_pinning;
+// Set on the threads of a ScopedThreadPinning and on parallel_for workers,
+// which inherit the setting of the thread that started them.
+static thread_local const ThreadPinning* scoped_pinning = nullptr;
+
+static vector<int> affinity_cpus() {
+    vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set))
+                cpus.push_back(cpu);
+#endif
+    return cpus;
+}
+
+static ThreadPinning current_pinning() {
+    if (scoped_pinning)
+        return *scoped_pinning;
+    lock_guard<mutex> lock(pinning_mutex);
+    return process_pinning;
+}
+
+#ifdef __linux__
+static void pin_current_thread(const vector<int>& cpus, int worker) {
+    if (cpus.empty())
+        return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpus[worker % cpus.size()], &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+#else
+static void pin_current_thread(const vector<int>&, int) {}
+#endif
+
+void set_thread_pinning(bool enabled) {
+    ThreadPinning next;
+    next.enabled = enabled;
+    if (enabled)
+        next.cpus = affinity_cpus();
+    lock_guard<mutex> lock(pinning_mutex);
+    process_pinning = move(next);
+}
+
+bool thread_pinning_enabled() {
+    return current_pinning().enabled;
+}
+
+ScopedThreadPinning::ScopedThreadPinning(bool enabled)
+    : saved(scoped_pinning) {
+    state.enabled = enabled;
+    if (enabled)
+        state.cpus = affinity_cpus();
+    scoped_pinning = &state;
+}
+
+ScopedThreadPinning::~ScopedThreadPinning() {
+    scoped_pinning = saved;
+}
+
+int default_thread_count() {
+    return max(1u, thread::hardware_concurrency());
+}
+
+// Memory placement policy of a thread (see numa_policy.h). Fresh threads
+// inherit their creator's, so pool helpers copy the caller's per call.
+struct MemPolicy {
+    bool valid = false;
+    int mode = 0;
+    unsigned long nodes[16] = {};
+
+    bool operator==(const MemPolicy& other) const {
+        return valid == other.valid && mode == other.mode &&
+               equal(nodes, nodes + 16, other.nodes);
+    }
+};
+
+static MemPolicy current_mempolicy() {
+    MemPolicy p;
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    p.valid = syscall(SYS_get_mempolicy, &p.mode, p.nodes,
+                      8 * sizeof(p.nodes), nullptr, 0) == 0;
+#endif
+    return p;
+}
+
+static void apply_mempolicy(const MemPolicy& p) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    if (p.valid)
+        syscall(SYS_set_mempolicy, p.mode, p.nodes, 8 * sizeof(p.nodes) + 1);
+#else
+    (void)p;
+#endif
+}
+
+// Helper threads kept across parallel_for calls, so a call costs a wake-up
+// instead of a thread start per worker. One call uses the pool at a time;
+// concurrent or nested calls (from a body) start their own threads as
+// before. Helper h runs as worker h + 1, takes the caller's memory policy
+// and gets its own affinity back after a pinned call.
+namespace {
+
+struct WorkerPool {
+    mutex in_use; // held by the parallel_for currently using the pool
+
+    mutex lock;
+    condition_variable wake, done;
+    vector<thread> helpers;
+    uint64_t generation = 0;
+    int active = 0;    // helpers taking part in the current call
+    int remaining = 0; // of those, helpers still running
+    bool pinned = false;
+    MemPolicy policy;
+    const function<void(int)>* job = nullptr;
+
+    // Starts job(1) ... job(count) on helpers; the caller runs job(0).
+    void start(int count, const function<void(int)>& f, bool pin) {
+        MemPolicy caller = current_mempolicy();
+        unique_lock<mutex> guard(lock);
+        while ((int)helpers.size() < count) {
+            int worker = (int)helpers.size() + 1;
+            helpers.emplace_back([this, worker] { loop(worker); });
+        }
+        job = &f;
+        active = remaining = count;
+        pinned = pin;
+        policy = caller;
+        generation++;
+        wake.notify_all();
+    }
+
+    void wait() {
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [this] { return remaining == 0; });
+        job = nullptr;
+    }
+
+    void loop(int worker);
+};
+
+// Never destroyed, so exit() on any thread does not wait for the helpers.
+WorkerPool& worker_pool() {
+    static WorkerPool* pool = new WorkerPool;
+    return *pool;
+}
+
+} // namespace
+
+// Set on pool helpers, whose nested parallel_for calls cannot wait on the
+// pool they belong to.
+static thread_local bool in_pool = false;
+
+void WorkerPool::loop(int worker) {
+    in_pool = true;
+#ifdef __linux__
+    cpu_set_t own;
+    bool have_own =
+        pthread_getaffinity_np(pthread_self(), sizeof(own), &own) == 0;
+#endif
+    MemPolicy own_policy = current_mempolicy();
+    uint64_t seen = 0;
+    unique_lock<mutex> guard(lock);
+    while (true) {
+        wake.wait(guard, [&] { return generation != seen; });
+        seen = generation;
+        if (worker > active)
+            continue;
+        const function<void(int)>& f = *job;
+        bool restore = pinned;
+        if (!(policy == own_policy)) {
+            apply_mempolicy(policy);
+            own_policy = policy;
+        }
+        guard.unlock();
+        f(worker);
+        scoped_pinning = nullptr;
+#ifdef __linux__
+        if (restore && have_own)
+            pthread_setaffinity_np(pthread_self(), sizeof(own), &own);
+#else
+        (void)restore;
+#endif
+        guard.lock();
+        if (--remaining == 0)
+            done.notify_all();
+    }
+}
+
+void parallel_for(int count, int threads,
+                  const function<void(int worker, int i)>& body, int chunk) {
+    if (threads <= 0)
+        threads = default_thread_count();
+    chunk = max(1, chunk);
+    threads = max(1, min(threads, (count + chunk - 1) / chunk));
+
+    ThreadPinning pinning = current_pinning();
+    bool pin = pinning.enabled;
+    atomic<int> next(0);
+    function<void(int)> run = [&](int worker) {
+        if (worker > 0)
+            scoped_pinning = &pinning;
+        if (pin && worker > 0)
+            pin_current_thread(pinning.cpus, worker);
+        while (true) {
+            int begin = next.fetch_add(chunk);
+            if (begin >= count)
+                break;
+            int end = min(count, begin + chunk);
+            for (int i = begin; i < end; ++i)
+                body(worker, i);
+        }
+    };
+
+#ifdef __linux__
+    cpu_set_t saved;
+    bool restore = pin && pthread_getaffinity_np(pthread_self(), sizeof(saved),
+                                                 &saved) == 0;
+    if (restore)
+        pin_current_thread(pinning.cpus, 0);
+#endif
+
+    WorkerPool& pool = worker_pool();
+    if (threads == 1) {
+        run(0);
+    } else if (!in_pool && pool.in_use.try_lock()) {
+        pool.start(threads - 1, run, pin);
+        run(0);
+        pool.wait();
+        pool.in_use.unlock();
+    } else {
+        vector<thread> spawned;
+        spawned.reserve(threads - 1);
+        for (int w = 1; w < threads; ++w)
+            spawned.emplace_back(run, w);
+        run(0);
+        for (auto& th : spawned)
+            th.join();
+    }
+
+#ifdef __linux__
+    if (restore)
+        pthread_setaffinity_np(pthread_self(), sizeof(saved), &saved);
+#endif
+}
@@ -0,0 +1,49 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+#include <vector>
+
+using namespace std;
+
+// Hardware concurrency, at least 1.
+int default_thread_count();
+
+// When enabled, parallel_for pins worker w to the w-th CPU (round-robin)
+// of the process affinity mask captured at enable time, so a worker keeps
+// its caches and its first-touch pages on one node. The calling thread,
+// which runs as worker 0, gets its previous affinity back afterwards.
+void set_thread_pinning(bool enabled);
+bool thread_pinning_enabled();
+
+struct ThreadPinning {
+    bool enabled = false;
+    vector<int> cpus; // affinity mask captured when enabled
+};
+
+// Overrides the process-wide setting for parallel_for calls made on this
+// thread, and by the workers they start, while in scope. Lets a library
+// call choose pinning without affecting concurrent calls.
+struct ScopedThreadPinning {
+    explicit ScopedThreadPinning(bool enabled);
+    ~ScopedThreadPinning();
+    ScopedThreadPinning(const ScopedThreadPinning&) = delete;
+    ScopedThreadPinning& operator=(const ScopedThreadPinning&) = delete;
+
+  private:
+    ThreadPinning state;
+    const ThreadPinning* saved;
+};
+
+// Runs body(worker, i) for every i in [0, count) on `threads` workers
+// (0 = default_thread_count()). Indices are handed out in chunks of `chunk`
+// through a shared counter, so uneven items balance across workers. Worker
+// ids are in [0, threads) and can index per-thread state. The caller runs
+// as worker 0; the others come from a process-wide pool that is reused
+// across calls, so short batches do not pay for thread creation. Nested or
+// concurrent calls that find the pool busy start their own threads.
+void parallel_for(int count, int threads,
+                  const function<void(int worker, int i)>& body,
+                  int chunk = 1);
+
+#endif // PARALLEL_H
@@ -0,0 +1,165 @@
+#include "partition.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+
+// Undirected neighbor lists in CSR form.
+struct UndirectedGraph {
+    vector<edge_t> start;
+    vector<int> nbr;
+
+    UndirectedGraph(int n, const vector<vector<Edge>>& adj)
+        : start(n + 1, 0) {
+        for (int u = 0; u < n; ++u)
+            for (const auto& e : adj[u]) {
+                start[u + 1]++;
+                start[e.to + 1]++;
+            }
+        for (int u = 0; u < n; ++u)
+            start[u + 1] += start[u];
+        nbr.resize(start[n]);
+        vector<edge_t> fill(start.begin(), start.end() - 1);
+        for (int u = 0; u < n; ++u)
+            for (const auto& e : adj[u]) {
+                nbr[fill[u]++] = e.to;
+                nbr[fill[e.to]++] = u;
+            }
+    }
+};
+
+struct Bisector {
+    const UndirectedGraph& g;
+    vector<int> label; // subset id of each vertex
+    vector<int> seen;  // BFS stamp
+    int stamp = 0;
+    int next_label = 1;
+
+    Bisector(int n, const UndirectedGraph& graph)
+        : g(graph), label(n, 0), seen(n, 0) {}
+
+    // BFS over `subset` starting at `root`, restarting at unvisited
+    // vertices so disconnected subsets are fully ordered.
+    void bfs(const vector<int>& subset, int root, int lab,
+             vector<int>& order) {
+        stamp++;
+        order.clear();
+        size_t head = 0;
+        size_t next_root = 0;
+        int start = root;
+        while (true) {
+            seen[start] = stamp;
+            order.push_back(start);
+            while (head < order.size()) {
+                int u = order[head++];
+                for (edge_t i = g.start[u]; i < g.start[u + 1]; ++i) {
+                    int v = g.nbr[i];
+                    if (label[v] == lab && seen[v] != stamp) {
+                        seen[v] = stamp;
+                        order.push_back(v);
+                    }
+                }
+            }
+            while (next_root < subset.size() &&
+                   seen[subset[next_root]] == stamp)
+                next_root++;
+            if (next_root == subset.size())
+                break;
+            start = subset[next_root];
+        }
+    }
+
+    // Splits `subset` (all labeled `lab`) into `parts` pieces, appending
+    // them to `out` in order. Each returned piece is in BFS order.
+    void split(vector<int>& subset, int lab, int parts,
+               vector<vector<int>>& out) {
+        vector<int> order;
+        // Pseudo-peripheral root: the last vertex of a BFS from an
+        // arbitrary vertex.
+        bfs(subset, subset[0], lab, order);
+        bfs(subset, order.back(), lab, order);
+
+        // A single vertex cannot be split further; the remaining parts of
+        // this subset stay empty.
+        if (parts <= 1 || subset.size() <= 1) {
+            out.push_back(move(order));
+            for (int i = 1; i < parts; ++i)
+                out.push_back({});
+            return;
+        }
+
+        int left_parts = parts / 2;
+        size_t cut = order.size() * left_parts / parts;
+        vector<int> left(order.begin(), order.begin() + cut);
+        vector<int> right(order.begin() + cut, order.end());
+        vector<int>().swap(subset);
+
+        int left_label = next_label++;
+        int right_label = next_label++;
+        for (int v : left)
+            label[v] = left_label;
+        for (int v : right)
+            label[v] = right_label;
+        if (!left.empty())
+            split(left, left_label, left_parts, out);
+        else
+            for (int i = 0; i < left_parts; ++i)
+                out.push_back({});
+        if (!right.empty())
+            split(right, right_label, parts - left_parts, out);
+        else
+            for (int i = 0; i < parts - left_parts; ++i)
+                out.push_back({});
+    }
+};
+
+} // namespace
+
+Partition partition_graph(vertex_t n, const vector<vector<Edge>>& adj,
+                          int parts) {
+    Partition p;
+    p.parts = max(1, parts);
+    p.part.assign(n, 0);
+    p.new_id.assign(n, 0);
+    p.order.reserve(n);
+    p.part_start.assign(p.parts + 1, 0);
+    if (n == 0)
+        return p;
+
+    UndirectedGraph g(n, adj);
+    Bisector bisector(n, g);
+    vector<int> all(n);
+    for (int v = 0; v < n; ++v)
+        all[v] = v;
+    vector<vector<int>> pieces;
+    bisector.split(all, 0, p.parts, pieces);
+
+    for (int i = 0; i < p.parts; ++i) {
+        p.part_start[i] = (vertex_t)p.order.size();
+        for (int v : pieces[i]) {
+            p.part[v] = i;
+            p.new_id[v] = (vertex_t)p.order.size();
+            p.order.push_back(v);
+        }
+    }
+    p.part_start[p.parts] = n;
+
+    for (int u = 0; u < n; ++u)
+        for (const auto& e : adj[u])
+            if (p.part[u] != p.part[e.to])
+                p.cut_edges++;
+    return p;
+}
+
+vector<vector<Edge>> permute_graph(const vector<vector<Edge>>& adj,
+                                   const vector<vertex_t>& new_id) {
+    vector<vector<Edge>> out(adj.size());
+    for (size_t u = 0; u < adj.size(); ++u) {
+        auto& row = out[new_id[u]];
+        row.reserve(adj[u].size());
+        for (const auto& e : adj[u])
+            row.push_back({new_id[e.to], e.weight});
+    }
+    return out;
+}
@@ -0,0 +1,32 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Vertex partition with a matching layout: vertices of each part get
+// contiguous new ids, ordered by BFS inside the part.
+struct Partition {
+    int parts = 0;
+    vector<int> part;       // part of each original vertex
+    vector<vertex_t> new_id;     // original id -> new id
+    vector<vertex_t> order;      // new id -> original id
+    vector<vertex_t> part_start; // parts + 1 offsets into the new id range
+    long long cut_edges = 0;
+};
+
+// Recursive bisection on the undirected view of the graph. Each step grows
+// a BFS from a pseudo-peripheral vertex of the current subset and splits
+// the visiting order in proportion to the parts on either side, so parts
+// come out balanced and connected where the graph allows.
+Partition partition_graph(vertex_t n, const vector<vector<Edge>>& adj,
+                          int parts);
+
+// Graph relabeled by new_id: row new_id[u] holds u's edges with renamed
+// targets.
+vector<vector<Edge>> permute_graph(const vector<vector<Edge>>& adj,
+                                   const vector<vertex_t>& new_id);
+
+#endif // PARTITION_H
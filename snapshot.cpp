@@ -0,0 +1,290 @@
+#include "snapshot.h"
+#include "graph.h"
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const size_t SECTION_ALIGN = 64;
+
+static size_t element_size(uint32_t type) {
+    switch (type) {
+    case SNAPSHOT_INT32:
+        return 4;
+    case SNAPSHOT_INT64:
+    case SNAPSHOT_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+static size_t align_up(size_t x) {
+    return (x + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+uint64_t snapshot_checksum(const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ bytes;
+    size_t words = bytes / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        memcpy(&w, p + i * 8, 8);
+        h ^= w * 0xff51afd7ed558ccdULL;
+        h = ((h << 27) | (h >> 37)) * 0x9e3779b97f4a7c15ULL;
+    }
+    for (size_t i = words * 8; i < bytes; ++i)
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+static void add_section(SnapshotWriter& w, const string& name, uint32_t type,
+                        const void* data, size_t count) {
+    SnapshotWriter::Pending p = {};
+    strncpy(p.section.name, name.c_str(), sizeof(p.section.name) - 1);
+    p.section.type = type;
+    p.section.count = count;
+    p.data = data;
+    w.pending.push_back(p);
+}
+
+void SnapshotWriter::add(const string& name, const int32_t* data,
+                         size_t count) {
+    add_section(*this, name, SNAPSHOT_INT32, data, count);
+}
+
+void SnapshotWriter::add(const string& name, const int64_t* data,
+                         size_t count) {
+    add_section(*this, name, SNAPSHOT_INT64, data, count);
+}
+
+void SnapshotWriter::add(const string& name, const double* data,
+                         size_t count) {
+    add_section(*this, name, SNAPSHOT_FLOAT64, data, count);
+}
+
+void SnapshotWriter::add_graph(const string& prefix, const CsrView& graph) {
+    size_t m = (size_t)graph.edge_count();
+    add(prefix + ".offsets", graph.offsets, (size_t)graph.n + 1);
+    add(prefix + ".targets", graph.targets, m);
+    add(prefix + ".weights", graph.weights, m);
+}
+
+void SnapshotWriter::add_landmarks(const Landmarks& landmarks) {
+    add("landmarks.ids", landmarks.ids.data(), landmarks.ids.size());
+    for (size_t i = 0; i < landmarks.ids.size(); ++i) {
+        add("landmarks.from." + to_string(i), landmarks.from[i].data(),
+            landmarks.from[i].size());
+        add("landmarks.to." + to_string(i), landmarks.to[i].data(),
+            landmarks.to[i].size());
+    }
+}
+
+bool SnapshotWriter::write(const string& path, string& error) const {
+    vector<SnapshotSection> table;
+    size_t pos = align_up(sizeof(SnapshotHeader) +
+                          pending.size() * sizeof(SnapshotSection));
+    for (const auto& p : pending) {
+        SnapshotSection s = p.section;
+        size_t bytes = s.count * element_size(s.type);
+        s.offset = pos;
+        s.checksum = snapshot_checksum(p.data, bytes);
+        table.push_back(s);
+        pos = align_up(pos + bytes);
+    }
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = SNAPSHOT_VERSION;
+    header.n = n;
+    header.m = m;
+    header.source = source;
+    header.sections = (uint32_t)table.size();
+    header.table_checksum =
+        snapshot_checksum(table.data(), table.size() * sizeof(SnapshotSection));
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        error = "cannot create " + path;
+        return false;
+    }
+    static const char zeros[SECTION_ALIGN] = {0};
+    size_t written = sizeof(header) + table.size() * sizeof(SnapshotSection);
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(table.data(), sizeof(SnapshotSection), table.size(), f) ==
+                  table.size();
+    for (size_t i = 0; ok && i < table.size(); ++i) {
+        size_t pad = table[i].offset - written;
+        size_t bytes = table[i].count * element_size(table[i].type);
+        ok = fwrite(zeros, 1, pad, f) == pad &&
+             fwrite(pending[i].data, 1, bytes, f) == bytes;
+        written = table[i].offset + bytes;
+    }
+    ok = fclose(f) == 0 && ok;
+    if (!ok)
+        error = "write failed";
+    return ok;
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    close();
+}
+
+bool MappedSnapshot::open(const string& path, string& error, bool verify) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        error = "file too small";
+        return false;
+    }
+    void* map = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        error = "cannot map " + path;
+        return false;
+    }
+    base = map;
+    length = st.st_size;
+
+    const char* bytes = (const char*)base;
+    memcpy(&header, bytes, sizeof(header));
+    size_t table_bytes = (size_t)header.sections * sizeof(SnapshotSection);
+    if (memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0) {
+        error = "not a snapshot";
+    } else if (header.version != SNAPSHOT_VERSION) {
+        error = "unsupported snapshot version";
+    } else if (header.n < 0 || header.m < 0 ||
+               sizeof(header) + table_bytes > length) {
+        error = "truncated snapshot";
+    } else if (snapshot_checksum(bytes + sizeof(header), table_bytes) !=
+               header.table_checksum) {
+        error = "section table checksum mismatch";
+    } else {
+        sections = (const SnapshotSection*)(bytes + sizeof(header));
+        string problem;
+        for (uint32_t i = 0; i < header.sections && problem.empty(); ++i) {
+            const SnapshotSection& s = sections[i];
+            size_t size = element_size(s.type);
+            string name(s.name, strnlen(s.name, sizeof(s.name)));
+            if (size == 0 || s.offset % 8 != 0 || s.offset > length ||
+                s.count > (length - s.offset) / size)
+                problem = "bad section " + name;
+            else if (verify &&
+                     snapshot_checksum(bytes + s.offset, s.count * size) !=
+                         s.checksum)
+                problem = "checksum mismatch in " + name;
+        }
+        if (problem.empty())
+            return true;
+        error = problem;
+    }
+    close();
+    return false;
+}
+
+void MappedSnapshot::close() {
+    if (base)
+        munmap((void*)base, length);
+    base = nullptr;
+    length = 0;
+    sections = nullptr;
+    header = SnapshotHeader();
+}
+
+const SnapshotSection* MappedSnapshot::find(const string& name,
+                                            SnapshotType type) const {
+    for (uint32_t i = 0; sections && i < header.sections; ++i)
+        if (sections[i].type == type &&
+            strncmp(sections[i].name, name.c_str(),
+                    sizeof(sections[i].name)) == 0)
+            return &sections[i];
+    return nullptr;
+}
+
+const void* MappedSnapshot::data(const SnapshotSection& section) const {
+    return (const char*)base + section.offset;
+}
+
+bool MappedSnapshot::graph(const string& prefix, CsrView& view) const {
+    const SnapshotSection* offsets = find(prefix + ".offsets", SNAPSHOT_INT64);
+    const SnapshotSection* targets = find(prefix + ".targets", SNAPSHOT_INT32);
+    const SnapshotSection* weights =
+        find(prefix + ".weights", SNAPSHOT_FLOAT64);
+    if (!offsets || !targets || !weights ||
+        header.n > numeric_limits<vertex_t>::max() ||
+        offsets->count != (uint64_t)header.n + 1 ||
+        targets->count != weights->count)
+        return false;
+    CsrView candidate;
+    candidate.n = (vertex_t)header.n;
+    candidate.offsets = (const edge_t*)data(*offsets);
+    candidate.targets = (const vertex_t*)data(*targets);
+    candidate.weights = (const double*)data(*weights);
+    if (candidate.offsets[candidate.n] != (edge_t)targets->count ||
+        !valid_csr(candidate))
+        return false;
+    view = candidate;
+    return true;
+}
+
+bool MappedSnapshot::landmarks(Landmarks& out) const {
+    const SnapshotSection* ids = find("landmarks.ids", SNAPSHOT_INT32);
+    if (!ids || ids->count == 0)
+        return false;
+    Landmarks lm;
+    const int32_t* id_data = (const int32_t*)data(*ids);
+    lm.ids.assign(id_data, id_data + ids->count);
+    for (size_t i = 0; i < lm.ids.size(); ++i) {
+        const SnapshotSection* from =
+            find("landmarks.from." + to_string(i), SNAPSHOT_FLOAT64);
+        const SnapshotSection* to =
+            find("landmarks.to." + to_string(i), SNAPSHOT_FLOAT64);
+        if (!from || !to || from->count != (uint64_t)header.n ||
+            to->count != (uint64_t)header.n)
+            return false;
+        const double* f = (const double*)data(*from);
+        const double* t = (const double*)data(*to);
+        lm.from.emplace_back(f, f + header.n);
+        lm.to.emplace_back(t, t + header.n);
+    }
+    out = move(lm);
+    return true;
+}
+
+bool load_snapshot_graph(const MappedSnapshot& snapshot, bool with_reverse,
+                         GraphInput& g, string& error) {
+    CsrView view;
+    if (!snapshot.graph("graph", view)) {
+        error = "snapshot has no valid graph sections";
+        return false;
+    }
+    g.n = view.n;
+    g.m = view.edge_count();
+    g.source = snapshot.header.source;
+    g.adj = csr_to_adjacency(view);
+    if (with_reverse) {
+        CsrView reverse;
+        if (snapshot.graph("reverse", reverse))
+            g.radj = csr_to_adjacency(reverse);
+        else
+            g.radj = reverse_graph(g.n, g.adj);
+    }
+    return true;
+}
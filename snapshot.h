@@ -0,0 +1,118 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "csr_graph.h"
+#include "graph_io.h"
+#include "landmarks.h"
+#include "types.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Snapshot of a built graph and arrays derived from it, laid out so that it
+// can be memory-mapped and used in place: header, section table, then the
+// data of every section aligned to 64 bytes. All values are little-endian.
+// Sections written by bmssp_solver --save-snapshot:
+//   graph.offsets (int64, n + 1), graph.targets (int32, m),
+//   graph.weights (float64, m)    the graph in CSR form
+//   reverse.*                     its transpose, same layout
+//   landmarks.ids (int32, k), landmarks.from.<i>, landmarks.to.<i>
+//                                 (float64, n) ALT tables, when computed
+// Other tools may add per-vertex arrays under their own names; readers skip
+// sections they do not know.
+const char SNAPSHOT_MAGIC[4] = {'B', 'M', 'S', 'N'};
+const uint32_t SNAPSHOT_VERSION = 1;
+
+enum SnapshotType : uint32_t {
+    SNAPSHOT_INT32 = 1,
+    SNAPSHOT_INT64 = 2,
+    SNAPSHOT_FLOAT64 = 3
+};
+
+struct SnapshotHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t n;
+    int64_t m;
+    int32_t source;
+    uint32_t sections;
+    uint64_t table_checksum; // over the section table
+};
+
+struct SnapshotSection {
+    char name[32]; // NUL-terminated
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;   // from the start of the file
+    uint64_t count;    // elements
+    uint64_t checksum; // over the data bytes
+};
+
+// 64-bit checksum of a byte range, eight bytes per step.
+uint64_t snapshot_checksum(const void* data, size_t bytes);
+
+// Collects sections and writes them in one pass. Arrays are not copied:
+// they must stay alive until write().
+struct SnapshotWriter {
+    int64_t n = 0;
+    int64_t m = 0;
+    int32_t source = 0;
+
+    void add(const string& name, const int32_t* data, size_t count);
+    void add(const string& name, const int64_t* data, size_t count);
+    void add(const string& name, const double* data, size_t count);
+
+    // Adds prefix.offsets, prefix.targets and prefix.weights.
+    void add_graph(const string& prefix, const CsrView& graph);
+    void add_landmarks(const Landmarks& landmarks);
+
+    bool write(const string& path, string& error) const;
+
+    struct Pending {
+        SnapshotSection section;
+        const void* data;
+    };
+    vector<Pending> pending;
+};
+
+// Read-only memory mapping of a snapshot. open() checks the header, the
+// section table and the bounds of every section; with `verify` it also
+// reads every section once to check its data checksum.
+struct MappedSnapshot {
+    SnapshotHeader header = {};
+    const SnapshotSection* sections = nullptr;
+
+    MappedSnapshot() = default;
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+    ~MappedSnapshot();
+
+    bool open(const string& path, string& error, bool verify = true);
+    void close();
+
+    // Section by name and type, null when absent.
+    const SnapshotSection* find(const string& name, SnapshotType type) const;
+    const void* data(const SnapshotSection& section) const;
+
+    // View of prefix.* as a CSR graph over header.n nodes. The arrays are
+    // checked with valid_csr, which reads them once. Returns false, leaving
+    // `view` unchanged, when the sections are missing or inconsistent.
+    bool graph(const string& prefix, CsrView& view) const;
+
+    // Copies the landmark tables. Returns false when there are none.
+    bool landmarks(Landmarks& out) const;
+
+    // The whole mapping, header included.
+    const void* base = nullptr;
+    size_t length = 0;
+};
+
+// Fills g as load_graph would from stdin: adj from the graph sections and,
+// with `with_reverse`, radj from the reverse sections (built from adj when
+// the snapshot has none).
+bool load_snapshot_graph(const MappedSnapshot& snapshot, bool with_reverse,
+                         GraphInput& g, string& error);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,129 @@
+#include "sssp_cache.h"
+#include "bmssp.h"
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+static inline uint64_t fnv_mix(uint64_t h, uint64_t v) {
+    for (int i = 0; i < 8; ++i) {
+        h ^= (v >> (i * 8)) & 0xff;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static inline uint64_t double_bits(double d) {
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    return bits;
+}
+
+uint64_t graph_fingerprint(vertex_t n, const vector<vector<Edge>>& adj) {
+    uint64_t h = 14695981039346656037ULL;
+    h = fnv_mix(h, (uint64_t)n);
+    for (int u = 0; u < n; ++u) {
+        h = fnv_mix(h, adj[u].size());
+        for (const auto& e : adj[u]) {
+            h = fnv_mix(h, (uint64_t)e.to);
+            h = fnv_mix(h, double_bits(e.weight));
+        }
+    }
+    return h;
+}
+
+size_t SsspCache::KeyHash::operator()(const Key& key) const {
+    uint64_t h = key.fingerprint;
+    h = fnv_mix(h, (uint64_t)key.source);
+    h = fnv_mix(h, double_bits(key.bound));
+    return (size_t)h;
+}
+
+SsspCache::SsspCache(size_t budget, double res)
+    : budget_bytes(budget), resolution(res) {}
+
+void SsspCache::erase(list<Entry>::iterator it) {
+    used_bytes -= it->bytes;
+    index.erase(it->key);
+    lru.erase(it);
+}
+
+bool SsspCache::lookup(const Key& key, vector<double>& out) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        stats.misses++;
+        return false;
+    }
+    stats.hits++;
+    lru.splice(lru.begin(), lru, it->second);
+    it->second->dist.decode(out);
+    return true;
+}
+
+void SsspCache::insert(const Key& key, const vector<double>& dist) {
+    CompressedDistances encoded;
+    try {
+        encoded = CompressedDistances(dist, resolution);
+    } catch (const overflow_error&) {
+        return;
+    }
+    size_t bytes = sizeof(Entry) + encoded.bytes();
+    if (bytes > budget_bytes)
+        return;
+
+    auto it = index.find(key);
+    if (it != index.end())
+        erase(it->second);
+
+    while (used_bytes + bytes > budget_bytes && !lru.empty()) {
+        erase(--lru.end());
+        stats.evictions++;
+    }
+
+    lru.push_front({key, move(encoded), bytes});
+    index[key] = lru.begin();
+    used_bytes += bytes;
+    stats.insertions++;
+}
+
+vector<double> SsspCache::solve(vertex_t n, const vector<vector<Edge>>& adj,
+                                uint64_t fingerprint, vertex_t source,
+                                double bound, bool* hit) {
+    Key key{fingerprint, source, bound};
+    vector<double> dist;
+    {
+        lock_guard<mutex> guard(solve_lock);
+        bool found = lookup(key, dist);
+        if (hit)
+            *hit = found;
+        if (found)
+            return dist;
+    }
+    dist = solve_sssp(n, adj, source, bound);
+    lock_guard<mutex> guard(solve_lock);
+    insert(key, dist);
+    // Hand back the quantized values a later hit would return, so callers
+    // see the same distances whether or not the query was cached.
+    auto it = index.find(key);
+    if (it != index.end())
+        it->second->dist.decode(dist);
+    return dist;
+}
+
+void SsspCache::invalidate(uint64_t fingerprint) {
+    for (auto it = lru.begin(); it != lru.end();) {
+        auto cur = it++;
+        if (cur->key.fingerprint == fingerprint) {
+            erase(cur);
+            stats.invalidations++;
+        }
+    }
+}
+
+void SsspCache::clear() {
+    stats.invalidations += lru.size();
+    lru.clear();
+    index.clear();
+    used_bytes = 0;
+}
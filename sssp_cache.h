@@ -0,0 +1,93 @@
+#ifndef SSSP_CACHE_H
+#define SSSP_CACHE_H
+
+#include "dist_codec.h"
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Order-sensitive hash of the adjacency structure. Two graphs with the same
+// fingerprint are treated as identical by the cache.
+uint64_t graph_fingerprint(vertex_t n, const vector<vector<Edge>>& adj);
+
+// LRU cache of solve_sssp results keyed by (graph fingerprint, source, bound),
+// bounded by an approximate memory budget in bytes. Results are held as
+// CompressedDistances quantized to `resolution`.
+struct SsspCache {
+    struct Key {
+        uint64_t fingerprint;
+        vertex_t source;
+        double bound;
+
+        bool operator==(const Key& other) const {
+            return fingerprint == other.fingerprint &&
+                   source == other.source && bound == other.bound;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t insertions = 0;
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;
+    };
+
+    struct Entry {
+        Key key;
+        CompressedDistances dist;
+        size_t bytes;
+    };
+
+    size_t budget_bytes;
+    double resolution;
+    size_t used_bytes = 0;
+    Stats stats;
+
+    // Most recently used entry at the front.
+    list<Entry> lru;
+    unordered_map<Key, list<Entry>::iterator, KeyHash> index;
+
+    explicit SsspCache(size_t budget, double resolution = 1e-6);
+
+    // Decodes the cached vector into `out` and marks it most recently used.
+    bool lookup(const Key& key, vector<double>& out);
+
+    // Stores a result, evicting least recently used entries to stay within
+    // budget. Results larger than the whole budget, or that do not fit the
+    // quantization range, are not cached.
+    void insert(const Key& key, const vector<double>& dist);
+
+    // Returns the cached result or runs solve_sssp and caches it. A result
+    // that was cached is returned at `resolution` on the miss as well.
+    // `hit` receives whether the query was served from the cache. Several
+    // threads may call solve at once; the solve itself runs unlocked, and
+    // the other members are not synchronized.
+    vector<double> solve(vertex_t n, const vector<vector<Edge>>& adj,
+                         uint64_t fingerprint, vertex_t source, double bound,
+                         bool* hit = nullptr);
+
+    // Drops every entry computed on the graph with this fingerprint.
+    void invalidate(uint64_t fingerprint);
+
+    void clear();
+
+    size_t size() const { return index.size(); }
+
+  private:
+    mutex solve_lock;
+
+    void erase(list<Entry>::iterator it);
+};
+
+#endif // SSSP_CACHE_H
@@ -0,0 +1,166 @@
+#include "bmssp.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "test_graphs.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Both bidirectional searches agree with a unidirectional Dijkstra on a
+// sparse graph where most pairs are disconnected, and on one with integer
+// and zero weights where meeting distances are often tied and must match
+// exactly.
+void test_random_pairs() {
+    cout << "\n=== Test s-t Distances ===" << endl;
+    int n = 3000;
+    auto sparse = random_graph(n, 3300, 3);
+    auto tied = random_graph(n, 12000, 2, true);
+    for (auto& row : tied)
+        for (Edge& e : row)
+            e.weight -= 1; // weights 0 .. 8
+    for (const auto* adj : {&sparse, &tied}) {
+        auto radj = reverse_graph(n, *adj);
+        bool exact_only = adj == &tied;
+        int pairs = 0, unreachable = 0;
+        bool dijkstra_ok = true, bmssp_ok = true;
+        for (int source : {0, 7, n - 1}) {
+            vector<double> exact = dijkstra(n, *adj, source);
+            for (int target = 0; target < n; target += 53) {
+                pairs++;
+                unreachable += exact[target] == INF;
+                double d = exact[target];
+                double bd =
+                    bidirectional_dijkstra(n, *adj, radj, source, target);
+                double bb = bidirectional_bmssp(n, *adj, radj, source, target);
+                dijkstra_ok = dijkstra_ok &&
+                              (exact_only ? bd == d : same_length(bd, d));
+                bmssp_ok = bmssp_ok &&
+                           (exact_only ? bb == d : same_length(bb, d));
+            }
+        }
+        string name = exact_only ? "zero-weight graph" : "sparse graph";
+        assert_true(dijkstra_ok, "Bidirectional Dijkstra matches on the " +
+                                     name + " (" + to_string(pairs) +
+                                     " pairs, " + to_string(unreachable) +
+                                     " unreachable)");
+        assert_true(bmssp_ok, "Bidirectional BMSSP matches on the " + name);
+    }
+}
+
+// On a chain both balls stay thin, so the bounds double many times before
+// the balls meet. Sums of 0.1 are rounded, so the stop test must not rely
+// on exact bound arithmetic.
+void test_chain() {
+    cout << "\n=== Test Long Chain ===" << endl;
+    int n = 5000;
+    vector<vector<Edge>> adj(n);
+    for (int v = 0; v + 1 < n; ++v)
+        adj[v].push_back({v + 1, 0.1});
+    auto radj = reverse_graph(n, adj);
+    vector<double> exact = dijkstra(n, adj, 0);
+    int rounds = 0;
+    bool ok = true;
+    for (int target : {1, 2, 100, n - 1})
+        ok = ok && same_length(bidirectional_bmssp(n, adj, radj, 0, target,
+                                                   &rounds),
+                               exact[target]);
+    assert_true(ok, "Chain distances with 0.1 weights match");
+    assert_true(rounds > 1 && rounds < 64,
+                "Far end found in " + to_string(rounds) + " bound steps");
+    assert_true(bidirectional_bmssp(n, adj, radj, n - 1, 0) == INF,
+                "Chain is not walked backwards");
+}
+
+// The best path may cross between the balls over one heavy edge whose
+// endpoints are both reached early, or over a detour of short edges.
+void test_meeting_edge() {
+    cout << "\n=== Test Meeting Edge ===" << endl;
+    // 0 -> 1 -> 2 -> 3 with a heavy middle edge, and a detour
+    // 1 -> 4 -> ... -> 13 -> 2 of eleven edges of weight 1.
+    int n = 14;
+    vector<vector<Edge>> adj(n);
+    adj[0].push_back({1, 1.0});
+    adj[2].push_back({3, 1.0});
+    adj[1].push_back({4, 1.0});
+    for (int v = 4; v < 13; ++v)
+        adj[v].push_back({v + 1, 1.0});
+    adj[13].push_back({2, 1.0});
+    adj[1].push_back({2, 11.0});
+    struct Case {
+        double heavy, expected;
+        const char* name;
+    };
+    for (const Case& c : {Case{11.0, 13.0, "Heavy edge ties the detour"},
+                          Case{10.5, 12.5, "Heavy edge wins when shorter"},
+                          Case{20.0, 13.0, "Detour wins when shorter"}}) {
+        adj[1].back().weight = c.heavy;
+        auto radj = reverse_graph(n, adj);
+        assert_true(bidirectional_bmssp(n, adj, radj, 0, 3) == c.expected &&
+                        bidirectional_dijkstra(n, adj, radj, 0, 3) ==
+                            c.expected,
+                    c.name);
+    }
+}
+
+void test_special_cases() {
+    cout << "\n=== Test Special Cases ===" << endl;
+    int n = 500;
+    auto adj = random_graph(n, 2000, 4);
+    auto radj = reverse_graph(n, adj);
+    int rounds = -1;
+    assert_true(bidirectional_bmssp(n, adj, radj, 42, 42, &rounds) == 0 &&
+                    rounds == 0,
+                "BMSSP: source == target is 0 without a search");
+    assert_true(bidirectional_dijkstra(n, adj, radj, 42, 42) == 0,
+                "Dijkstra: source == target is 0");
+
+    // Two components joined by nothing, and a one-way bridge.
+    vector<vector<Edge>> split(6);
+    split[0].push_back({1, 1.0});
+    split[1].push_back({0, 1.0});
+    split[2].push_back({3, 2.0});
+    split[3].push_back({4, 0.0});
+    split[4].push_back({2, 1.0});
+    split[1].push_back({5, 3.0});
+    auto rsplit = reverse_graph(6, split);
+    assert_true(bidirectional_bmssp(6, split, rsplit, 0, 3) == INF &&
+                    bidirectional_dijkstra(6, split, rsplit, 0, 3) == INF,
+                "Disconnected target is unreachable");
+    assert_true(bidirectional_bmssp(6, split, rsplit, 5, 0) == INF &&
+                    bidirectional_dijkstra(6, split, rsplit, 5, 0) == INF,
+                "Sink node reaches nothing");
+    assert_true(bidirectional_bmssp(6, split, rsplit, 0, 5) == 4.0 &&
+                    bidirectional_dijkstra(6, split, rsplit, 0, 5) == 4.0,
+                "One-way edge is followed forward");
+    assert_true(bidirectional_bmssp(6, split, rsplit, 2, 4) == 2.0 &&
+                    bidirectional_dijkstra(6, split, rsplit, 2, 4) == 2.0,
+                "Zero-weight edge on the path");
+}
+
+int main() {
+    cout << "Starting Bidirectional Search Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_random_pairs();
+    test_chain();
+    test_meeting_edge();
+    test_special_cases();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <map>
 #include <random>
 #include <set>
 #include <vector>
@@ -415,6 +416,62 @@ void test_stress_pull_consistency() {
     }
 }
 
+void test_pull_ties_at_bound() {
+    cout << "\n=== Test Pull Ties At Bound ===" << endl;
+    BlockList bl(2, 100.0);
+
+    for (int i = 0; i < 5; i++) {
+        bl.insert(i, 7.0);
+    }
+    bl.insert(5, 9.0);
+
+    auto result = bl.pull();
+    assert_true(result.frontier.size() == 5,
+                "All elements tied at the smallest distance are pulled");
+    assert_true(result.bound == 9.0,
+                "Bound is strictly above the pulled distance");
+}
+
+void test_random_ties_bound() {
+    cout << "\n=== Test Random Ties Bound ===" << endl;
+    mt19937 rng(7);
+    uniform_int_distribution<int> node_dist(0, 199);
+    uniform_int_distribution<int> value_dist(0, 20);
+    bool ok = true;
+
+    for (int M = 1; M <= 4 && ok; M++) {
+        BlockList bl(M, 100.0);
+        map<int, double> present;
+        double floor_value = 0; // pulled values never drop below this
+        for (int op = 0; op < 3000 && ok; op++) {
+            if (op % 4 != 3) {
+                int u = node_dist(rng);
+                double d = floor_value + value_dist(rng);
+                if (d >= 100.0)
+                    continue;
+                bl.insert(u, d);
+                auto it = present.find(u);
+                if (it == present.end() || d < it->second)
+                    present[u] = d;
+                continue;
+            }
+            if (bl.is_empty())
+                continue;
+            auto result = bl.pull();
+            double pulled_max = 0;
+            for (int u : result.frontier) {
+                pulled_max = max(pulled_max, present[u]);
+                present.erase(u);
+            }
+            for (const auto& kv : present)
+                ok = ok && kv.second >= result.bound;
+            ok = ok && pulled_max < result.bound;
+            floor_value = result.bound == 100.0 ? floor_value : result.bound;
+        }
+    }
+    assert_true(ok, "Bound separates pulled and remaining with many ties");
+}
+
 int main() {
     cout << "Starting BlockList Correctness Tests..." << endl;
     cout << "=======================================" << endl;
@@ -438,6 +495,8 @@ int main() {
         test_random_operations();
         test_batch_prepend_overwrites_insert();
         test_stress_pull_consistency();
+        test_pull_ties_at_bound();
+        test_random_ties_bound();
 
         cout << "\n=======================================" << endl;
         cout << "ALL TESTS PASSED!" << endl;
@@ -0,0 +1,144 @@
+#include "bmssp.h"
+#include "dijkstra.h"
+#include "test_graphs.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Every reported distance is exact, and every reported node other than the
+// source hangs off a reported predecessor over a tight edge.
+static bool partial_exact(const vector<vector<Edge>>& adj, int source,
+                          const vector<double>& partial,
+                          const vector<double>& exact,
+                          const vector<vertex_t>* parents) {
+    for (size_t v = 0; v < partial.size(); ++v) {
+        if (partial[v] == INF) {
+            if (parents && (*parents)[v] != -1)
+                return false;
+            continue;
+        }
+        if (partial[v] != exact[v])
+            return false;
+        if (!parents || (int)v == source)
+            continue;
+        int p = (*parents)[v];
+        if (p < 0 || partial[p] == INF)
+            return false;
+        bool found = false;
+        for (const auto& e : adj[p])
+            found = found ||
+                    ((size_t)e.to == v && partial[p] + e.weight == partial[v]);
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+static size_t reported(const vector<double>& dist) {
+    size_t count = 0;
+    for (double d : dist)
+        count += d != INF;
+    return count;
+}
+
+void test_immediate_stop() {
+    cout << "\n=== Test Immediate Stop ===" << endl;
+    int n = 2000;
+    auto adj = random_graph(n, 8000, 1);
+    SolveStatus status;
+    SsspOptions opts;
+    opts.status = &status;
+
+    CancelToken token;
+    token.cancel();
+    opts.cancel = &token;
+    vector<double> dist = solve_sssp(n, adj, 0, opts);
+    assert_true(status == SOLVE_CANCELLED, "Cancelled token stops the solve");
+    assert_true(dist[0] == 0 && reported(dist) < (size_t)n,
+                "Only proven distances are reported");
+
+    opts.cancel = nullptr;
+    opts.deadline = chrono::steady_clock::now();
+    dist = solve_sssp(n, adj, 0, opts);
+    assert_true(status == SOLVE_DEADLINE && dist[0] == 0,
+                "Past deadline stops the solve");
+
+    CancelToken idle;
+    opts.cancel = &idle;
+    opts.deadline = chrono::steady_clock::now() + chrono::hours(1);
+    dist = solve_sssp(n, adj, 0, opts);
+    assert_true(status == SOLVE_COMPLETE && dist == solve_sssp(n, adj, 0),
+                "Unfired stop sources change nothing");
+}
+
+void test_partial_results() {
+    cout << "\n=== Test Partial Results ===" << endl;
+    int n = 100000;
+    auto adj = random_graph(n, 400000, 2);
+    vector<double> exact = dijkstra(n, adj, 0);
+
+    for (int threads : {0, 2}) {
+        for (int budget_us : {200, 2000, 20000}) {
+            SolveStatus status;
+            vector<vertex_t> parents;
+            SsspOptions opts;
+            opts.threads = threads;
+            opts.status = &status;
+            opts.parents = &parents;
+            opts.deadline =
+                chrono::steady_clock::now() + chrono::microseconds(budget_us);
+            vector<double> dist = solve_sssp(n, adj, 0, opts);
+            string mode = "(threads " + to_string(threads) + ", " +
+                          to_string(budget_us) + " us, " +
+                          to_string(reported(dist)) + " proven)";
+            assert_true(partial_exact(adj, 0, dist, exact, &parents),
+                        "Proven distances and tree are exact " + mode);
+        }
+    }
+
+    // Cancel from another thread while the solve runs.
+    CancelToken token;
+    SolveStatus status;
+    SsspOptions opts;
+    opts.cancel = &token;
+    opts.status = &status;
+    thread canceller([&] {
+        this_thread::sleep_for(chrono::milliseconds(2));
+        token.cancel();
+    });
+    vector<double> dist = solve_sssp(n, adj, 0, opts);
+    canceller.join();
+    assert_true(partial_exact(adj, 0, dist, exact, nullptr),
+                "Cancellation from another thread keeps proven distances");
+    assert_true(status == SOLVE_COMPLETE
+                    ? dist == exact
+                    : status == SOLVE_CANCELLED && reported(dist) < (size_t)n,
+                "Status matches the result");
+}
+
+int main() {
+    cout << "Starting Cancellation Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_immediate_stop();
+    test_partial_results();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include "bmssp_capi.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Test utilities */
+static void assert_true(int condition, const char* message) {
+    if (!condition) {
+        fprintf(stderr, "FAILED: %s\n", message);
+        exit(1);
+    }
+    printf("PASSED: %s\n", message);
+}
+
+/* 0 -> 1 (1), 0 -> 2 (4), 1 -> 2 (2), 2 -> 3 (1), 1 -> 3 (7); node 4 is
+ * unreachable. */
+#define N 5
+static const int64_t offsets[N + 1] = {0, 2, 4, 5, 5, 5};
+static const int32_t targets[5] = {1, 2, 2, 3, 3};
+static const double weights[5] = {1, 4, 2, 7, 1};
+
+static void test_create(void) {
+    printf("\n=== Test Graph Creation ===\n");
+    bmssp_graph* graph = NULL;
+    assert_true(bmssp_api_version() == BMSSP_API_VERSION,
+                "Library matches the header version");
+    assert_true(bmssp_graph_create(N, offsets, targets, weights, &graph) ==
+                        BMSSP_OK &&
+                    bmssp_graph_node_count(graph) == N,
+                "Graph wraps the CSR arrays");
+    bmssp_graph_free(graph);
+
+    static const int32_t bad_targets[5] = {1, 2, 2, 3, 9};
+    static const double bad_weights[5] = {1, 4, 2, -7, 1};
+    static const int64_t bad_offsets[N + 1] = {0, 2, 1, 5, 5, 5};
+    assert_true(bmssp_graph_create(N, offsets, bad_targets, weights, &graph) ==
+                        BMSSP_INVALID_ARGUMENT &&
+                    graph == NULL,
+                "Target out of range rejected");
+    assert_true(bmssp_graph_create(N, offsets, targets, bad_weights, &graph) ==
+                    BMSSP_INVALID_ARGUMENT,
+                "Negative weight rejected");
+    assert_true(bmssp_graph_create(N, bad_offsets, targets, weights, &graph) ==
+                    BMSSP_INVALID_ARGUMENT,
+                "Decreasing offsets rejected");
+}
+
+static void test_solve(void) {
+    printf("\n=== Test Solve ===\n");
+    bmssp_graph* graph = NULL;
+    bmssp_graph_create(N, offsets, targets, weights, &graph);
+    double dist[N];
+    int32_t parents[N];
+    assert_true(bmssp_solve(graph, 0, NULL, dist, parents) == BMSSP_OK,
+                "Solve with default options");
+    assert_true(dist[0] == 0 && dist[1] == 1 && dist[2] == 3 &&
+                    dist[3] == 4 && isinf(dist[4]),
+                "Distances are correct");
+    assert_true(parents[0] == -1 && parents[1] == 0 && parents[2] == 1 &&
+                    parents[3] == 2 && parents[4] == -1,
+                "Shortest path tree is correct");
+
+    bmssp_options opts;
+    bmssp_options_init(&opts);
+    opts.bound = 3.5;
+    opts.threads = 2;
+    assert_true(bmssp_solve(graph, 0, &opts, dist, NULL) == BMSSP_OK &&
+                    dist[2] == 3 && isinf(dist[3]),
+                "Bound and threads honoured");
+
+    /* A caller built against a header that ended after `bound`. */
+    opts.size = offsetof(bmssp_options, threads);
+    opts.bound = 2;
+    assert_true(bmssp_solve(graph, 0, &opts, dist, NULL) == BMSSP_OK &&
+                    dist[1] == 1 && isinf(dist[2]),
+                "Shorter options struct accepted");
+
+    assert_true(bmssp_solve(graph, N, NULL, dist, NULL) ==
+                    BMSSP_INVALID_ARGUMENT,
+                "Source out of range rejected");
+    bmssp_graph_free(graph);
+}
+
+static void test_batch(void) {
+    printf("\n=== Test Batch Solve ===\n");
+    bmssp_graph* graph = NULL;
+    bmssp_graph_create(N, offsets, targets, weights, &graph);
+    int32_t sources[3] = {0, 1, 2};
+    double dist[3 * N];
+    bmssp_options opts;
+    bmssp_options_init(&opts);
+    opts.batch_threads = 2;
+    assert_true(bmssp_solve_batch(graph, sources, 3, &opts, dist) == BMSSP_OK,
+                "Batch solve succeeds");
+    int ok = 1;
+    for (int i = 0; i < 3; ++i) {
+        double single[N];
+        bmssp_solve(graph, sources[i], NULL, single, NULL);
+        for (int v = 0; v < N; ++v)
+            ok = ok && (single[v] == dist[i * N + v] ||
+                        (isinf(single[v]) && isinf(dist[i * N + v])));
+    }
+    assert_true(ok, "Batch rows match single solves");
+
+    double pinned[3 * N];
+    opts.pin_threads = 1;
+    opts.threads = 2;
+    assert_true(bmssp_solve_batch(graph, sources, 3, &opts, pinned) ==
+                        BMSSP_OK &&
+                    memcmp(pinned, dist, sizeof(dist)) == 0,
+                "Pinned batch gives the same rows");
+    opts.pin_threads = 0;
+    opts.threads = 0;
+
+    sources[2] = -1;
+    assert_true(bmssp_solve_batch(graph, sources, 3, &opts, dist) ==
+                    BMSSP_INVALID_ARGUMENT,
+                "Invalid source fails the batch");
+    bmssp_graph_free(graph);
+}
+
+static void test_cancel(void) {
+    printf("\n=== Test Cancellation ===\n");
+    bmssp_graph* graph = NULL;
+    bmssp_graph_create(N, offsets, targets, weights, &graph);
+    bmssp_cancel_token* token = NULL;
+    assert_true(bmssp_cancel_token_create(&token) == BMSSP_OK,
+                "Token created");
+    bmssp_options opts;
+    bmssp_options_init(&opts);
+    opts.cancel = token;
+    double dist[3 * N];
+    assert_true(bmssp_solve(graph, 0, &opts, dist, NULL) == BMSSP_OK &&
+                    dist[3] == 4,
+                "Unfired token changes nothing");
+
+    bmssp_cancel_token_cancel(token);
+    assert_true(bmssp_solve(graph, 0, &opts, dist, NULL) == BMSSP_CANCELLED &&
+                    dist[0] == 0 && isinf(dist[3]),
+                "Cancelled solve keeps only proven distances");
+    int32_t sources[3] = {0, 1, 2};
+    assert_true(bmssp_solve_batch(graph, sources, 3, &opts, dist) ==
+                        BMSSP_CANCELLED &&
+                    dist[0] == 0 && dist[N + 1] == 0 && dist[2 * N + 2] == 0,
+                "Cancelled batch still fills every source");
+    bmssp_cancel_token_free(token);
+    bmssp_graph_free(graph);
+}
+
+/* Sums the visited distances; stops after `limit` nodes. */
+typedef struct {
+    int count;
+    int limit;
+    double sum;
+} visit_totals;
+
+static int add_visit(void* context, int32_t node, double dist) {
+    visit_totals* totals = (visit_totals*)context;
+    (void)node;
+    totals->sum += dist;
+    return ++totals->count < totals->limit;
+}
+
+static void test_visit(void) {
+    printf("\n=== Test Visitor ===\n");
+    bmssp_graph* graph = NULL;
+    bmssp_graph_create(N, offsets, targets, weights, &graph);
+    visit_totals totals = {0, N, 0};
+    assert_true(bmssp_visit(graph, 0, NULL, add_visit, &totals) == BMSSP_OK &&
+                    totals.count == 4 && totals.sum == 8,
+                "Every reached node visited once");
+    visit_totals first = {0, 1, 0};
+    assert_true(bmssp_visit(graph, 0, NULL, add_visit, &first) == BMSSP_OK &&
+                    first.count == 1 && first.sum == 0,
+                "Visitor stops after the source");
+    assert_true(bmssp_visit(graph, 0, NULL, NULL, NULL) ==
+                    BMSSP_INVALID_ARGUMENT,
+                "Missing callback rejected");
+    bmssp_graph_free(graph);
+}
+
+static void test_nearest(void) {
+    printf("\n=== Test Nearest ===\n");
+    bmssp_graph* graph = NULL;
+    bmssp_graph_create(N, offsets, targets, weights, &graph);
+    int32_t nodes[N];
+    double dist[N];
+    int32_t found = -1;
+    assert_true(bmssp_nearest(graph, 0, 3, NULL, NULL, nodes, dist, &found) ==
+                        BMSSP_OK &&
+                    found == 3 && nodes[0] == 0 && nodes[1] == 1 &&
+                    nodes[2] == 2 && dist[2] == 3,
+                "Nearest nodes in distance order");
+    uint64_t category = (1u << 1) | (1u << 3);
+    assert_true(bmssp_nearest(graph, 0, N, &category, NULL, nodes, dist,
+                              &found) == BMSSP_OK &&
+                    found == 2 && nodes[0] == 1 && nodes[1] == 3 &&
+                    dist[1] == 4,
+                "Category filter and reachable limit");
+    bmssp_graph_free(graph);
+}
+
+int main(void) {
+    printf("Starting C API Tests...\n");
+    printf("=======================================\n");
+
+    test_create();
+    test_solve();
+    test_batch();
+    test_cancel();
+    test_visit();
+    test_nearest();
+
+    printf("\n=======================================\n");
+    printf("ALL TESTS PASSED!\n");
+    printf("=======================================\n");
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "ch.h"
+#include "dijkstra.h"
+#include "graph_io.h"
+#include "test_graphs.h"
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Upward edges go up in rank and downward edges come down, and the rank is
+// a permutation.
+static bool hierarchy_valid(const ContractionHierarchy& ch) {
+    vector<char> seen(ch.n, 0);
+    for (int v = 0; v < ch.n; ++v) {
+        if (ch.rank[v] < 0 || ch.rank[v] >= ch.n || seen[ch.rank[v]])
+            return false;
+        seen[ch.rank[v]] = 1;
+    }
+    for (int u = 0; u < ch.n; ++u) {
+        for (const auto& e : ch.up[u])
+            if (ch.rank[e.to] <= ch.rank[u])
+                return false;
+        for (const auto& e : ch.down[u])
+            if (ch.rank[e.to] <= ch.rank[u])
+                return false;
+    }
+    return true;
+}
+
+// Point-to-point and one-to-many queries agree with Dijkstra on a sparse
+// graph where most pairs are unreachable, and on one with integer and
+// zero weights, where witness searches see many ties and the distances
+// must match exactly.
+void test_random_queries() {
+    cout << "\n=== Test CH Queries ===" << endl;
+    int n = 1500;
+    auto sparse = random_graph(n, 1800, 3);
+    auto tied = random_graph(n, 4500, 2, true);
+    for (auto& row : tied)
+        for (Edge& e : row)
+            e.weight -= 1; // weights 0 .. 8
+    for (const auto* adj : {&sparse, &tied}) {
+        bool exact_only = adj == &tied;
+        string name = exact_only ? "zero-weight graph" : "sparse graph";
+        ContractionHierarchy ch = build_ch(n, *adj);
+        assert_true(ch.n == n && hierarchy_valid(ch),
+                    "Hierarchy of the " + name + " is ranked consistently (" +
+                        to_string(ch.shortcuts) + " shortcuts)");
+
+        ChQuery query(ch);
+        vector<vertex_t> targets;
+        for (vertex_t t = 0; t < n; t += 17)
+            targets.push_back(t);
+        int unreachable = 0;
+        bool p2p_ok = true, one_to_many_ok = true;
+        for (vertex_t source : {0, 5, n / 3, n - 1}) {
+            vector<double> exact = dijkstra(n, *adj, source);
+            vector<double> row = query.one_to_many(source, targets);
+            for (size_t i = 0; i < targets.size(); ++i) {
+                double e = exact[targets[i]];
+                unreachable += e == INF;
+                double d = query.distance(source, targets[i]);
+                p2p_ok = p2p_ok && (exact_only ? d == e : same_length(d, e));
+                one_to_many_ok = one_to_many_ok &&
+                                 (exact_only ? row[i] == e
+                                             : same_length(row[i], e));
+            }
+        }
+        assert_true(p2p_ok, "Point-to-point queries match on the " + name +
+                                " (" + to_string(unreachable) +
+                                " unreachable)");
+        assert_true(one_to_many_ok, "One-to-many queries match on the " + name);
+    }
+}
+
+// Self-loops and parallel edges never become hierarchy edges that stay on
+// one rank, and the lighter of two parallel edges is the one used.
+void test_loops_and_parallel_edges() {
+    cout << "\n=== Test Loops And Parallel Edges ===" << endl;
+    int n = 5;
+    vector<vector<Edge>> adj(n);
+    adj[0].push_back({0, 1.0});
+    adj[0].push_back({1, 5.0});
+    adj[0].push_back({1, 2.0});
+    adj[1].push_back({2, 1.0});
+    adj[1].push_back({1, 0.0});
+    adj[2].push_back({3, 4.0});
+    adj[2].push_back({3, 3.0});
+    adj[3].push_back({4, 1.0});
+    adj[4].push_back({0, 1.0});
+    ContractionHierarchy ch = build_ch(n, adj);
+    assert_true(hierarchy_valid(ch), "No self-loop survives contraction");
+
+    ChQuery query(ch);
+    bool same = true;
+    for (vertex_t s = 0; s < n; ++s) {
+        vector<double> exact = dijkstra(n, adj, s);
+        for (vertex_t t = 0; t < n; ++t)
+            same = same && query.distance(s, t) == exact[t];
+    }
+    assert_true(same && query.distance(0, 4) == 7.0,
+                "Lighter parallel edges are used");
+}
+
+// Leaves of a star have an edge difference of -1 and the hub one of
+// in * out - (in + out), so the leaves go first and no shortcut is needed.
+void test_star_order() {
+    cout << "\n=== Test Contraction Order ===" << endl;
+    int n = 11, hub = 0;
+    vector<vector<Edge>> adj(n);
+    for (vertex_t v = 1; v <= 5; ++v)
+        adj[v].push_back({hub, 1.0});
+    for (vertex_t v = 6; v < n; ++v)
+        adj[hub].push_back({v, 2.0});
+    ContractionHierarchy ch = build_ch(n, adj);
+    assert_true(ch.shortcuts == 0, "Star needs no shortcuts");
+    assert_true(ChQuery(ch).distance(3, 8) == 3.0, "Leaf to leaf via the hub");
+}
+
+// One ChQuery reused across mixed queries answers like a fresh instance:
+// labels left by a previous query must not leak into the next one.
+void test_query_reuse() {
+    cout << "\n=== Test Query State Reuse ===" << endl;
+    int n = 600;
+    auto adj = random_graph(n, 1800, 9);
+    ContractionHierarchy ch = build_ch(n, adj);
+    ChQuery reused(ch);
+    vector<pair<vertex_t, double>> space;
+    bool same = true;
+    for (vertex_t s = 0; s < n; s += 41) {
+        vertex_t t = (s * 7 + 3) % n;
+        reused.upward_space(s, s % 2 == 0, space);
+        double d = reused.distance(s, t);
+        vector<double> row = reused.one_to_many(t, {s, t});
+        ChQuery fresh(ch);
+        same = same && d == fresh.distance(s, t) &&
+               row == fresh.one_to_many(t, {s, t});
+    }
+    assert_true(same, "Reused query state answers like a fresh one");
+
+    vector<double> row = reused.one_to_many(4, {});
+    assert_true(row.empty(), "No targets gives an empty row");
+    row = reused.one_to_many(4, {4, 9, 4});
+    assert_true(row.size() == 3 && row[0] == 0 && row[2] == 0 &&
+                    row[1] == reused.distance(4, 9),
+                "Repeated targets and the source itself are answered");
+}
+
+void test_file_round_trip() {
+    cout << "\n=== Test CH File Round Trip ===" << endl;
+    int n = 800;
+    auto adj = random_graph(n, 2400, 7);
+    ContractionHierarchy ch = build_ch(n, adj);
+    string path = "test_ch.bin";
+    assert_true(write_ch(path, ch), "Hierarchy written");
+
+    ContractionHierarchy back;
+    assert_true(read_ch(path, back), "Hierarchy read back");
+    remove(path.c_str());
+    assert_true(back.n == n && back.rank == ch.rank, "Ranks preserved");
+
+    ChQuery a(ch), b(back);
+    bool same = true;
+    for (int s = 0; s < n; s += 97)
+        for (int t = 0; t < n; t += 13)
+            same = same && a.distance(s, t) == b.distance(s, t);
+    assert_true(same, "Loaded hierarchy answers the same");
+}
+
+// Rewrites `size` bytes at `offset` (from the end when negative).
+static void patch(const string& path, long offset, const void* bytes,
+                  size_t size) {
+    FILE* f = fopen(path.c_str(), "r+b");
+    fseek(f, offset, offset < 0 ? SEEK_END : SEEK_SET);
+    fwrite(bytes, 1, size, f);
+    fclose(f);
+}
+
+void test_corrupt_file() {
+    cout << "\n=== Test CH File Validation ===" << endl;
+    int n = 200;
+    ContractionHierarchy ch = build_ch(n, random_graph(n, 600, 8));
+    string path = "test_ch_corrupt.bin";
+    ContractionHierarchy back;
+
+    // The header claims far more edges than the file holds.
+    write_ch(path, ch);
+    uint32_t m = 4000000000u;
+    patch(path, offsetof(BinaryHeader, m), &m, sizeof(m));
+    assert_true(!read_ch(path, back), "Edge count beyond the file rejected");
+
+    write_ch(path, ch);
+    FILE* f = fopen(path.c_str(), "ab");
+    fputc(0, f);
+    fclose(f);
+    assert_true(!read_ch(path, back), "Trailing bytes rejected");
+
+    // Two nodes share rank 0.
+    write_ch(path, ch);
+    int32_t ranks[2] = {0, 0};
+    patch(path, -(long)(n * sizeof(int32_t)), ranks, sizeof(ranks));
+    assert_true(!read_ch(path, back), "Duplicate rank rejected");
+
+    write_ch(path, ch);
+    double w = -1.0;
+    patch(path, sizeof(BinaryHeader) + offsetof(BinaryEdge, w), &w, sizeof(w));
+    assert_true(!read_ch(path, back), "Negative weight rejected");
+
+    write_ch(path, ch);
+    assert_true(read_ch(path, back), "Intact file still reads");
+    remove(path.c_str());
+}
+
+int main() {
+    cout << "Starting Contraction Hierarchy Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_random_queries();
+    test_loops_and_parallel_edges();
+    test_star_order();
+    test_query_reuse();
+    test_file_round_trip();
+    test_corrupt_file();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
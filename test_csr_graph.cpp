@@ -0,0 +1,265 @@
+#include "bmssp.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "huge_pages.h"
+#include "test_graphs.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+void test_layout() {
+    cout << "\n=== Test CSR Layout ===" << endl;
+    vector<vector<Edge>> adj = random_graph(50, 200, 1);
+    CsrGraph csr = build_csr(50, adj);
+    CsrView view = csr.view();
+    assert_true(view.edge_count() == 200, "Edge count preserved");
+
+    bool same = true;
+    for (int u = 0; u < 50; ++u) {
+        size_t i = 0;
+        same = same && view[u].size() == adj[u].size();
+        for (const auto& e : view[u]) {
+            same = same && e.to == adj[u][i].to &&
+                   e.weight == adj[u][i].weight;
+            i++;
+        }
+    }
+    assert_true(same, "Rows match adjacency lists in order");
+}
+
+void test_solver_on_csr() {
+    cout << "\n=== Test Solver on CSR ===" << endl;
+    int n = 3000;
+    vector<vector<Edge>> adj = random_graph(n, 12000, 2);
+    vector<double> expected = solve_sssp(n, adj, 0);
+
+    for (HugePageMode mode : {HUGE_OFF, HUGE_THP, HUGE_EXPLICIT}) {
+        set_huge_page_mode(mode);
+        CsrGraph csr = build_csr(n, adj);
+        SsspOptions opts;
+        assert_true(solve_sssp(csr.view(), 0, opts) == expected,
+                    string("CSR distances match (") +
+                        huge_page_mode_name(mode) + ")");
+    }
+    set_huge_page_mode(HUGE_OFF);
+}
+
+void test_parallel_build() {
+    cout << "\n=== Test Parallel CSR Build ===" << endl;
+    // Enough edges for several chunks, so the cursors of different chunks
+    // meet inside rows.
+    int n = 5000;
+    mt19937 rng(5);
+    uniform_int_distribution<int> node(0, n - 1);
+    vector<BinaryEdge> edges;
+    vector<vector<Edge>> adj(n);
+    for (int i = 0; i < 300000; ++i) {
+        BinaryEdge e = {node(rng), node(rng), (double)(i % 7)};
+        edges.push_back(e);
+        adj[e.u].push_back({e.v, e.w});
+    }
+    CsrGraph expected = build_csr(n, adj);
+
+    for (int threads : {1, 3, 4}) {
+        CsrGraph csr = build_csr(n, edges, threads);
+        assert_true(csr.offsets == expected.offsets &&
+                        csr.targets == expected.targets &&
+                        csr.weights == expected.weights,
+                    "Parallel build keeps row order (" + to_string(threads) +
+                        " threads)");
+    }
+
+    CsrGraph sorted = build_csr(n, edges, 4, true);
+    bool same = sorted.offsets == expected.offsets;
+    for (int u = 0; u < n && same; ++u) {
+        vector<pair<vertex_t, double>> want, got;
+        for (const auto& e : adj[u])
+            want.push_back({e.to, e.weight});
+        sort(want.begin(), want.end());
+        for (const auto& e : sorted.view()[u])
+            got.push_back({e.to, e.weight});
+        same = got == want;
+    }
+    assert_true(same, "Sorted rows hold the same edges ordered by target");
+}
+
+// Loads the binary graph file at `path` through stdin.
+static LoadStatus load_binary_file(const string& path, GraphInput& g,
+                                   vector<BinaryEdge>& edges) {
+    if (!freopen(path.c_str(), "rb", stdin))
+        return LOAD_EMPTY;
+    return load_edges(true, g, edges);
+}
+
+void test_binary_header() {
+    cout << "\n=== Test Binary Header Edge Count ===" << endl;
+    // A header claiming more than 2^31 edges, followed by only two records:
+    // the count must survive as a 64-bit value, and the loader must see the
+    // file is short instead of reserving memory for every claimed edge.
+    string path = "test_csr_header.bin";
+    BinaryHeader header = {3, 3000000000u, 0};
+    BinaryEdge records[2] = {{0, 1, 1.5}, {1, 2, 2.0}};
+    FILE* f = fopen(path.c_str(), "wb");
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(records, sizeof(BinaryEdge), 2, f);
+    fclose(f);
+
+    GraphInput g;
+    vector<BinaryEdge> edges;
+    LoadStatus status = load_binary_file(path, g, edges);
+    assert_true(status == LOAD_TRUNCATED && g.m == 3000000000LL &&
+                    edges.capacity() < 1000,
+                "Edge count above 2^31 is kept and checked against the file");
+
+    header.m = 2;
+    f = fopen(path.c_str(), "wb");
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(records, sizeof(BinaryEdge), 2, f);
+    fclose(f);
+    GraphInput small;
+    status = load_binary_file(path, small, edges);
+    remove(path.c_str());
+    assert_true(status == LOAD_OK && small.m == 2 && edges.size() == 2 &&
+                    edges[1].v == 2,
+                "Complete file loads");
+}
+
+static LoadStatus load_text_file(const string& path, const string& text,
+                                 GraphInput& g, vector<BinaryEdge>& edges) {
+    FILE* f = fopen(path.c_str(), "w");
+    fputs(text.c_str(), f);
+    fclose(f);
+    if (!freopen(path.c_str(), "r", stdin))
+        return LOAD_EMPTY;
+    cin.clear();
+    LoadStatus status = load_edges(false, g, edges);
+    remove(path.c_str());
+    return status;
+}
+
+void test_text_edge_count() {
+    cout << "\n=== Test Text Edge Count ===" << endl;
+    string path = "test_csr_header.txt";
+    GraphInput g;
+    vector<BinaryEdge> edges;
+    assert_true(load_text_file(path, "3 9000000000000\n0 1 1\n", g, edges) ==
+                        LOAD_TRUNCATED &&
+                    edges.capacity() < 10000000,
+                "Huge text edge count is not reserved up front");
+    assert_true(load_text_file(path, "4 5\n0 1 1\n1 2 2\n", g, edges) ==
+                    LOAD_TRUNCATED,
+                "Missing edge lines are reported");
+    assert_true(load_text_file(path, "4 2\n0 1 1\n1 x 2\n", g, edges) ==
+                    LOAD_TRUNCATED,
+                "Malformed edge line is reported");
+    assert_true(load_text_file(path, "4 2\n0 1 1\n1 2 2\n3\n", g, edges) ==
+                        LOAD_OK &&
+                    edges.size() == 2 && g.source == 3,
+                "Complete text graph loads");
+}
+
+void test_huge_vector() {
+    cout << "\n=== Test Huge Page Vector ===" << endl;
+    set_huge_page_mode(HUGE_THP);
+    size_t count = 3 * HUGE_PAGE_SIZE / sizeof(double);
+    HugeVector<double> v(count, 1.5);
+    v.back() = 2.5;
+    assert_true(v[0] == 1.5 && v[count - 1] == 2.5,
+                "Large vector readable and writable");
+    assert_true(huge_page_stats().thp_bytes >= count * sizeof(double),
+                "Large vector is counted as transparent");
+    HugeVector<int> small(10, 7);
+    assert_true(small[9] == 7, "Small vector served from the heap");
+    set_huge_page_mode(HUGE_OFF);
+}
+
+void test_compressed() {
+    cout << "\n=== Test Compressed Graph ===" << endl;
+    int n = 3000;
+    vector<vector<Edge>> adj = random_graph(n, 12000, 3);
+    for (auto& row : adj)
+        for (auto& e : row)
+            e.weight = floor(e.weight * 1e6); // integral: lossless
+    CompressedGraph packed = compress_graph(n, adj);
+    assert_true(packed.scale == 1 && packed.m == 12000,
+                "Integral weights use unit resolution");
+
+    bool same = true;
+    for (int u = 0; u < n; ++u) {
+        vector<Edge> row = adj[u];
+        sort(row.begin(), row.end(),
+             [](const Edge& a, const Edge& b) { return a.to < b.to; });
+        size_t i = 0;
+        for (const auto& e : packed.view()[u]) {
+            same = same && i < row.size() && e.to == row[i].to &&
+                   e.weight == row[i].weight;
+            i++;
+        }
+        same = same && i == row.size();
+    }
+    assert_true(same, "Rows decode to the sorted input rows");
+    assert_true(solve_sssp(packed.view(), 0) == solve_sssp(n, adj, 0),
+                "Distances match on the compressed graph");
+    SsspOptions prefetch;
+    prefetch.prefetch_distance = 4;
+    assert_true(solve_sssp(packed.view(), 0, prefetch) ==
+                    solve_sssp(n, adj, 0),
+                "Distances match with prefetching");
+
+    for (auto& row : adj)
+        for (auto& e : row)
+            e.weight = e.weight / 8 + 0.125; // multiples of 2^-3
+    CompressedGraph dyadic = compress_graph(n, adj);
+    assert_true(dyadic.scale == 0.125 && dyadic.max_relative_error == 0 &&
+                    solve_sssp(dyadic.view(), 0) == solve_sssp(n, adj, 0),
+                "Binary fractions are stored losslessly");
+
+    // Arbitrary real weights are rounded, each by a bounded relative error,
+    // so path lengths keep the same bound.
+    const double bound = ldexp(1.0, -(RELATIVE_BITS + 1));
+    vector<vector<Edge>> real = random_graph(n, 12000, 4);
+    CompressedGraph lossy = compress_graph(n, real);
+    vector<double> exact = solve_sssp(n, real, 0);
+    vector<double> rounded = solve_sssp(lossy.view(), 0);
+    bool close = true;
+    for (int v = 0; v < n; ++v)
+        close = close && (exact[v] == rounded[v] ||
+                          fabs(rounded[v] - exact[v]) <= bound * exact[v]);
+    assert_true(lossy.max_relative_error > 0 &&
+                    lossy.max_relative_error <= bound && close,
+                "Real weights stay within the relative error bound");
+}
+
+int main() {
+    cout << "Starting CSR Graph Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_layout();
+    test_solver_on_csr();
+    test_parallel_build();
+    test_binary_header();
+    test_text_edge_count();
+    test_huge_vector();
+    test_compressed();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
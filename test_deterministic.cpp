@@ -0,0 +1,139 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "test_graphs.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Every reached node's label is its predecessor's label plus the weight of
+// an edge between them, and following predecessors reaches the source (no
+// cycles through zero-weight edges).
+static bool parents_consistent(const vector<vector<Edge>>& adj, int source,
+                               const vector<double>& dist,
+                               const vector<vertex_t>& parents) {
+    vector<char> on_tree(dist.size(), 0);
+    on_tree[source] = 1;
+    for (size_t v = 0; v < dist.size(); ++v) {
+        vector<int> path;
+        int u = (int)v;
+        while (dist[u] != INF && !on_tree[u] && path.size() <= dist.size()) {
+            path.push_back(u);
+            u = parents[u] < 0 ? source : parents[u];
+        }
+        if (path.size() > dist.size())
+            return false;
+        for (int x : path)
+            on_tree[x] = 1;
+    }
+    for (size_t v = 0; v < dist.size(); ++v) {
+        if ((int)v == source || dist[v] == INF) {
+            if (parents[v] != -1)
+                return false;
+            continue;
+        }
+        int p = parents[v];
+        if (p < 0)
+            return false;
+        bool found = false;
+        for (const auto& e : adj[p])
+            found = found || ((size_t)e.to == v && dist[p] + e.weight == dist[v]);
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+void test_thread_counts(bool integral) {
+    cout << "\n=== Test Thread Counts (" << (integral ? "integer" : "real")
+         << " weights) ===" << endl;
+    int n = 40000;
+    vector<vector<Edge>> adj = random_graph(n, 200000, 5, integral);
+    CsrGraph csr = build_csr(n, adj);
+
+    vector<double> base_dist;
+    vector<vertex_t> base_parents;
+    for (int threads = 1; threads <= 8; threads *= 2) {
+        SsspOptions opts;
+        opts.threads = threads;
+        vector<vertex_t> parents;
+        opts.parents = &parents;
+        vector<double> dist = solve_sssp(n, adj, 0, opts);
+        if (threads == 1) {
+            base_dist = dist;
+            base_parents = parents;
+            assert_true(parents_consistent(adj, 0, dist, parents),
+                        "Predecessors form a shortest path tree");
+            continue;
+        }
+        assert_true(dist == base_dist && parents == base_parents,
+                    to_string(threads) + " threads match 1 thread");
+    }
+
+    SsspOptions opts;
+    opts.threads = 4;
+    vector<vertex_t> parents;
+    opts.parents = &parents;
+    assert_true(solve_sssp(csr.view(), 0, opts) == base_dist &&
+                    parents == base_parents,
+                "CSR graph gives the same result");
+}
+
+// Weights of 0 and 1 make almost every distance tied and put zero-weight
+// cycles on many shortest paths.
+void test_tied_paths() {
+    cout << "\n=== Test Predecessors Under Ties ===" << endl;
+    mt19937 rng(9);
+    for (int round = 0; round < 40; ++round) {
+        int n = 50 + round * 25;
+        vector<vector<Edge>> adj(n);
+        uniform_int_distribution<int> node(0, n - 1);
+        for (int i = 0; i < 4 * n; ++i) {
+            int u = node(rng);
+            int v = node(rng);
+            adj[u].push_back({v, (double)(rng() & 1)});
+        }
+        for (int threads : {0, 1, 3}) {
+            for (bool strict : {false, true}) {
+                SsspOptions opts;
+                opts.threads = threads;
+                opts.strict = strict;
+                vector<vertex_t> parents;
+                opts.parents = &parents;
+                vector<double> dist = solve_sssp(n, adj, 0, opts);
+                if (!parents_consistent(adj, 0, dist, parents))
+                    assert_true(false, "Tree on " + to_string(n) +
+                                           " nodes, " + to_string(threads) +
+                                           " threads, strict " +
+                                           to_string(strict));
+            }
+        }
+    }
+    assert_true(true, "Predecessors form a tree on 0/1-weight graphs");
+}
+
+int main() {
+    cout << "Starting Deterministic Mode Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_thread_counts(false);
+    test_thread_counts(true);
+    test_tied_paths();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
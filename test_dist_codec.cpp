@@ -0,0 +1,152 @@
+#include "dist_codec.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+static bool close_to(const vector<double>& a, const vector<double>& b,
+                     double tol) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] == INF || b[i] == INF) {
+            if (a[i] != b[i])
+                return false;
+        } else if (fabs(a[i] - b[i]) > tol) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void test_round_trip() {
+    cout << "\n=== Test Round Trip ===" << endl;
+    mt19937 rng(7);
+    uniform_real_distribution<double> dist(0.0, 5000.0);
+    vector<double> d(1000);
+    for (auto& x : d)
+        x = dist(rng);
+    for (int i = 0; i < 1000; i += 7)
+        d[i] = INF;
+
+    CompressedDistances cd(d, 1e-3);
+    assert_true(close_to(cd.decode(), d, 0.5e-3), "Bulk decode within tolerance");
+
+    bool random_ok = true;
+    for (int i = 0; i < 1000; ++i) {
+        double v = cd[i];
+        if (d[i] == INF ? v != INF : fabs(v - d[i]) > 0.5e-3)
+            random_ok = false;
+    }
+    assert_true(random_ok, "Random access matches input");
+    assert_true(cd.bytes() < d.size() * sizeof(double),
+                "Encoding is smaller than dense doubles");
+}
+
+void test_edge_cases() {
+    cout << "\n=== Test Edge Cases ===" << endl;
+    CompressedDistances empty(vector<double>{}, 1e-3);
+    assert_true(empty.decode().empty(), "Empty vector");
+
+    vector<double> all_inf(130, INF);
+    CompressedDistances cd_inf(all_inf, 1e-3);
+    assert_true(cd_inf.decode() == all_inf, "All unreachable");
+    assert_true(cd_inf.packed.size() <= 2, "Unreachable entries use no bits");
+
+    vector<double> constant(100, 42.0);
+    CompressedDistances cd_const(constant, 1e-3);
+    assert_true(cd_const.decode() == constant, "Constant block has width 0");
+
+    vector<double> wide = {0.0, 1e12, 3.5, INF, 7e11};
+    CompressedDistances cd_wide(wide, 1e-3);
+    assert_true(close_to(cd_wide.decode(), wide, 1e-3),
+                "Wide range spans word boundaries");
+
+    bool threw = false;
+    try {
+        CompressedDistances bad(vector<double>{1e30}, 1e-6);
+    } catch (const overflow_error&) {
+        threw = true;
+    }
+    assert_true(threw, "Out of range distance rejected");
+}
+
+void test_serialization() {
+    cout << "\n=== Test Serialization ===" << endl;
+    vector<double> d = {0.0, 1.25, INF, 3.75, 1000.5, INF, 2.0};
+    CompressedDistances cd(d, 0.25);
+    stringstream ss;
+    assert_true(cd.write(ss), "Write succeeds");
+
+    CompressedDistances back;
+    assert_true(back.read(ss), "Read succeeds");
+    assert_true(back.decode() == d, "Decoded file matches input");
+
+    stringstream bad("XXXX");
+    assert_true(!back.read(bad), "Bad magic rejected");
+
+    vector<double> many(300);
+    for (size_t i = 0; i < many.size(); ++i)
+        many[i] = i * 7.5;
+    CompressedDistances big(many, 0.5);
+    auto rejected = [&](CompressedDistances corrupt) {
+        stringstream io;
+        corrupt.write(io);
+        CompressedDistances out;
+        return !out.read(io);
+    };
+    CompressedDistances wide_block = big;
+    wide_block.block_width[1] = 200;
+    assert_true(rejected(wide_block), "Block width above 64 rejected");
+    CompressedDistances far_block = big;
+    far_block.block_start[0] = big.packed.size() * 64;
+    assert_true(rejected(far_block), "Block start past the data rejected");
+    CompressedDistances short_data = big;
+    short_data.packed.resize(2);
+    assert_true(rejected(short_data), "Truncated bit data rejected");
+    CompressedDistances extra_block = big;
+    extra_block.block_base.push_back(0);
+    assert_true(rejected(extra_block),
+                "Array longer than the block count rejected");
+
+    // A huge array count must fail before anything is allocated for it.
+    stringstream io;
+    big.write(io);
+    string bytes = io.str();
+    uint64_t huge = 1ULL << 62;
+    bytes.replace(20, sizeof(huge), (const char*)&huge, sizeof(huge));
+    stringstream huge_count(bytes);
+    CompressedDistances out;
+    assert_true(!out.read(huge_count), "Huge array count rejected");
+}
+
+int main() {
+    cout << "Starting Distance Codec Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_round_trip();
+    test_edge_cases();
+    test_serialization();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
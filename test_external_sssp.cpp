@@ -0,0 +1,128 @@
+#include "csr_file.h"
+#include "dijkstra.h"
+#include "external_sssp.h"
+#include "graph_io.h"
+#include "test_graphs.h"
+#include <cstddef>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+void test_file_round_trip() {
+    cout << "\n=== Test CSR File Round Trip ===" << endl;
+    vector<vector<Edge>> adj = random_graph(100, 400, 1);
+    CsrGraph csr = build_csr(100, adj);
+    string path = "test_external_sssp.csr";
+    assert_true(write_csr_file(path, csr.view()), "CSR file written");
+
+    MappedCsr mapped;
+    string error;
+    assert_true(mapped.open(path, error), "CSR file mapped");
+    bool same = mapped.view.n == 100 && mapped.view.edge_count() == 400;
+    for (int u = 0; u < 100 && same; ++u)
+        for (size_t i = 0; i < adj[u].size(); ++i)
+            same = same && mapped.view[u][i].to == adj[u][i].to &&
+                   mapped.view[u][i].weight == adj[u][i].weight;
+    assert_true(same, "Mapped rows match the graph");
+    mapped.close();
+
+    // Each corruption is written into a fresh copy of the file.
+    auto patched = [&](long offset, const void* value, size_t size) {
+        write_csr_file(path, csr.view());
+        FILE* f = fopen(path.c_str(), "r+b");
+        fseek(f, offset, SEEK_SET);
+        fwrite(value, size, 1, f);
+        fclose(f);
+        return mapped.open(path, error);
+    };
+    const long offsets_at = sizeof(CsrFileHeader);
+    const long targets_at = offsets_at + 101 * sizeof(edge_t);
+    assert_true(!patched(0, "X", 1), "Bad magic rejected");
+    int64_t huge_n = (int64_t)1 << 33;
+    assert_true(!patched(offsetof(CsrFileHeader, n), &huge_n, sizeof(huge_n)) &&
+                    error == "CSR node count out of range",
+                "Node count above 32-bit ids rejected");
+    int64_t huge_m = (int64_t)1 << 60;
+    assert_true(!patched(offsetof(CsrFileHeader, m), &huge_m, sizeof(huge_m)),
+                "Edge count beyond the file rejected");
+    edge_t back = 1;
+    assert_true(!patched(offsets_at + 50 * sizeof(edge_t), &back,
+                         sizeof(back)),
+                "Decreasing offsets rejected");
+    vertex_t outside = 100;
+    assert_true(!patched(targets_at, &outside, sizeof(outside)) &&
+                    error == "corrupt CSR arrays",
+                "Target outside the graph rejected");
+    remove(path.c_str());
+}
+
+void test_convert() {
+    cout << "\n=== Test Streaming Conversion ===" << endl;
+    vector<vector<Edge>> adj = random_graph(200, 1000, 2);
+    string bin = "test_external_sssp.bin", csr = "test_external_sssp2.csr";
+    assert_true(write_graph(bin.c_str(), 200, adj, 7), "Binary graph written");
+    vertex_t source = -1;
+    string error;
+    assert_true(convert_to_csr_file(bin, csr, source, error) && source == 7,
+                "Conversion succeeds and keeps the source");
+
+    MappedCsr mapped;
+    assert_true(mapped.open(csr, error), "Converted file mapped");
+    CsrGraph expected = build_csr(200, adj);
+    bool same = true;
+    for (edge_t i = 0; i < 1000; ++i)
+        same = same && mapped.view.targets[i] == expected.targets[i] &&
+               mapped.view.weights[i] == expected.weights[i];
+    assert_true(same, "Converted edges keep input order per row");
+    mapped.close();
+
+    adj[3].push_back({4, -1.0});
+    assert_true(write_graph(bin.c_str(), 200, adj, 7), "Binary graph written");
+    remove(csr.c_str());
+    assert_true(!convert_to_csr_file(bin, csr, source, error) &&
+                    !mapped.open(csr, error),
+                "Negative weight rejected before the output is created");
+    remove(bin.c_str());
+}
+
+void test_external_distances() {
+    cout << "\n=== Test External SSSP ===" << endl;
+    int n = 5000;
+    vector<vector<Edge>> adj = random_graph(n, 20000, 3);
+    CsrGraph csr = build_csr(n, adj);
+    vector<double> expected = dijkstra(n, adj, 0);
+
+    ExternalOptions opts;
+    opts.block_nodes = 64;
+    opts.buffer_bytes = 4096; // a few blocks: forces evictions
+    BlockBuffer::Stats stats;
+    vector<double> dist = external_sssp(csr.view(), 0, opts, &stats);
+    assert_true(dist == expected, "Distances match Dijkstra");
+    assert_true(stats.evictions > 0, "Small buffer evicts blocks");
+}
+
+int main() {
+    cout << "Starting External SSSP Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_file_round_trip();
+    test_convert();
+    test_external_distances();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef TEST_GRAPHS_H
+#define TEST_GRAPHS_H
+
+#include "types.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace std;
+
+// Random directed multigraph fixture shared by the tests: m edges with
+// uniform endpoints and weights in [1, 10). Integral weights are floored,
+// which makes equal distances common.
+inline vector<vector<Edge>> random_graph(int n, int m, unsigned seed,
+                                         bool integral = false) {
+    mt19937 rng(seed);
+    uniform_int_distribution<int> node(0, n - 1);
+    uniform_real_distribution<double> weight(1.0, 10.0);
+    vector<vector<Edge>> adj(n);
+    for (int i = 0; i < m; ++i) {
+        int u = node(rng);
+        int v = node(rng);
+        double w = weight(rng);
+        adj[u].push_back({v, integral ? floor(w) : w});
+    }
+    return adj;
+}
+
+// Path lengths summed in another order (two search halves, shortcuts)
+// may differ from Dijkstra's in the last bits.
+inline bool same_length(double a, double b) {
+    if (a == INFINITY || b == INFINITY)
+        return a == b;
+    return fabs(a - b) <= 1e-9 * max(1.0, fabs(b));
+}
+
+#endif // TEST_GRAPHS_H
@@ -0,0 +1,188 @@
+#include "bmssp.h"
+#include "dijkstra.h"
+#include "graph.h"
+#include "landmarks.h"
+#include "test_graphs.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// ALT pruning and A* agree with Dijkstra on a sparse graph where many
+// pairs are unreachable, and with zero-weight edges where many targets are
+// reached on tied paths. Pruning must not drop a node whose bound only
+// equals the best target label.
+void test_target_distances() {
+    cout << "\n=== Test Target Distances ===" << endl;
+    int n = 2000;
+    auto sparse = random_graph(n, 2200, 3);
+    auto tied = random_graph(n, 8000, 2, true);
+    for (auto& row : tied)
+        for (Edge& e : row)
+            e.weight -= 1; // weights 0 .. 8
+    for (const auto* adj : {&sparse, &tied}) {
+        auto radj = reverse_graph(n, *adj);
+        Landmarks lm = select_landmarks(n, *adj, radj, 4);
+        int unreachable = 0;
+        bool alt_ok = true, astar_ok = true, admissible = true;
+        for (int source : {0, 1, n / 2}) {
+            vector<double> exact = dijkstra(n, *adj, source);
+            for (int target = 0; target < n; target += 37) {
+                unreachable += exact[target] == INF;
+                SsspOptions opts;
+                opts.target = target;
+                opts.landmarks = &lm;
+                alt_ok = alt_ok && solve_sssp(n, *adj, source, opts)[target] ==
+                                       exact[target];
+                astar_ok = astar_ok && astar(n, *adj, source, target, lm) ==
+                                           exact[target];
+                double h = lm.lower_bound(source, target);
+                admissible = admissible && h <= exact[target] &&
+                             (h != INF || exact[target] == INF);
+            }
+        }
+        string name = adj == &sparse ? "sparse graph" : "zero-weight graph";
+        assert_true(alt_ok, "Landmark pruning matches on the " + name + " (" +
+                                to_string(unreachable) + " unreachable)");
+        assert_true(astar_ok, "A* matches on the " + name);
+        assert_true(admissible, "Lower bounds are admissible on the " + name);
+    }
+}
+
+// With the target (or source) a landmark, the bound is its table entry
+// minus the rounding slack, and a node's bound to itself is 0.
+void test_bound_at_landmarks() {
+    cout << "\n=== Test Bounds At Landmarks ===" << endl;
+    int n = 1000;
+    auto adj = random_graph(n, 5000, 5);
+    auto radj = reverse_graph(n, adj);
+    Landmarks lm = select_landmarks(n, adj, radj, 3, 17);
+    assert_true(lm.ids.size() == 3 && lm.ids[0] == 17,
+                "Selection starts at the requested node");
+
+    bool to_tight = true, from_tight = true, self_zero = true;
+    for (size_t i = 0; i < lm.ids.size(); ++i) {
+        vertex_t l = lm.ids[i];
+        for (vertex_t v = 0; v < n; v += 7) {
+            double d = lm.to[i][v], h = lm.lower_bound(v, l);
+            to_tight = to_tight &&
+                       (d == INF ? h == INF : h <= d && h >= d * (1 - 1e-8));
+            d = lm.from[i][v];
+            h = lm.lower_bound(l, v);
+            from_tight = from_tight &&
+                         (d == INF ? h == INF : h <= d && h >= d * (1 - 1e-8));
+            self_zero = self_zero && lm.lower_bound(v, v) == 0;
+        }
+    }
+    assert_true(to_tight, "Bound to a landmark is its distance");
+    assert_true(from_tight, "Bound from a landmark is its distance");
+    assert_true(self_zero, "Bound from a node to itself is 0");
+}
+
+// A consistent heuristic never makes A* settle more nodes than a Dijkstra
+// search stopping at the target (A* with no landmarks).
+void test_astar_settles_fewer() {
+    cout << "\n=== Test A* Search Space ===" << endl;
+    int n = 3000;
+    auto adj = random_graph(n, 12000, 1);
+    auto radj = reverse_graph(n, adj);
+    Landmarks lm = select_landmarks(n, adj, radj, 8);
+    Landmarks none;
+    long long with_alt = 0, without = 0;
+    for (int source : {0, 9, n - 1}) {
+        for (int target = 1; target < n; target += 101) {
+            long long a = 0, b = 0;
+            astar(n, adj, source, target, lm, &a);
+            astar(n, adj, source, target, none, &b);
+            with_alt += a;
+            without += b;
+        }
+    }
+    assert_true(with_alt < without,
+                "A* settles " + to_string(with_alt) + " nodes, Dijkstra " +
+                    to_string(without));
+}
+
+void test_selection_limits() {
+    cout << "\n=== Test Landmark Selection ===" << endl;
+    // Three components: 0 <-> 1, 2 -> 3 -> 4, and the isolated node 5.
+    int n = 6;
+    vector<vector<Edge>> adj(n);
+    adj[0].push_back({1, 1.0});
+    adj[1].push_back({0, 1.0});
+    adj[2].push_back({3, 1.0});
+    adj[3].push_back({4, 2.0});
+    auto radj = reverse_graph(n, adj);
+
+    Landmarks lm = select_landmarks(n, adj, radj, 10);
+    vector<vertex_t> ids = lm.ids;
+    sort(ids.begin(), ids.end());
+    assert_true(ids.size() == (size_t)n &&
+                    unique(ids.begin(), ids.end()) == ids.end(),
+                "More landmarks than nodes selects every node once");
+
+    lm = select_landmarks(n, adj, radj, 3);
+    vector<int> per_component(3, 0);
+    for (vertex_t l : lm.ids)
+        per_component[l < 2 ? 0 : l < 5 ? 1 : 2]++;
+    assert_true(per_component == vector<int>({1, 1, 1}),
+                "Unconnected components are covered first");
+
+    assert_true(select_landmarks(0, {}, {}, 4).empty(),
+                "Empty graph has no landmarks");
+}
+
+void test_unreachable() {
+    cout << "\n=== Test Unreachable Targets ===" << endl;
+    // Two components: 0 -> 1 -> 2 and 3 -> 4, plus 5 reaching into the
+    // first one.
+    int n = 6;
+    vector<vector<Edge>> adj(n);
+    adj[0].push_back({1, 1.0});
+    adj[1].push_back({2, 2.0});
+    adj[3].push_back({4, 1.5});
+    adj[5].push_back({0, 4.0});
+    auto radj = reverse_graph(n, adj);
+    Landmarks lm = select_landmarks(n, adj, radj, 2);
+
+    SsspOptions opts;
+    opts.landmarks = &lm;
+    opts.target = 4;
+    assert_true(solve_sssp(n, adj, 0, opts)[4] == INF,
+                "Other component stays unreachable with landmarks");
+    opts.target = 5;
+    assert_true(solve_sssp(n, adj, 0, opts)[5] == INF,
+                "Node with only outgoing edges is unreachable");
+    opts.target = 2;
+    assert_true(solve_sssp(n, adj, 5, opts)[2] == 7.0,
+                "Path into the other landmark's component is found");
+}
+
+int main() {
+    cout << "Starting Landmark Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_target_distances();
+    test_bound_at_landmarks();
+    test_astar_settles_fewer();
+    test_selection_limits();
+    test_unreachable();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "ch.h"
+#include "dijkstra.h"
+#include "many_to_many.h"
+#include "test_graphs.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// The table agrees with one Dijkstra per origin. Integer weights keep the
+// shortcut sums exact.
+static bool matches_dijkstra(int n, const vector<vector<Edge>>& adj,
+                             const vector<int>& origins,
+                             const vector<int>& destinations,
+                             const DistanceTable& table, int& unreachable) {
+    if (table.rows != (int)origins.size() ||
+        table.cols != (int)destinations.size())
+        return false;
+    unreachable = 0;
+    for (int i = 0; i < table.rows; ++i) {
+        vector<double> exact = dijkstra(n, adj, origins[i]);
+        for (int j = 0; j < table.cols; ++j) {
+            unreachable += exact[destinations[j]] == INF;
+            if (table.at(i, j) != exact[destinations[j]])
+                return false;
+        }
+    }
+    return true;
+}
+
+void test_table() {
+    cout << "\n=== Test Distance Table ===" << endl;
+    // Sparse enough that many pairs are unreachable.
+    int n = 1200;
+    auto adj = random_graph(n, 1700, 1, true);
+    ContractionHierarchy ch = build_ch(n, adj);
+
+    vector<vertex_t> origins = {0, 3, 17, 250, 999, 3};
+    vector<vertex_t> destinations = {5, 0, 42, 1100, 17, 600, 42, 7};
+    for (int threads : {1, 3}) {
+        DistanceTable table = many_to_many(ch, origins, destinations, threads);
+        int unreachable = 0;
+        bool same = matches_dijkstra(n, adj, origins, destinations, table,
+                                     unreachable);
+        assert_true(same, "Table matches Dijkstra with " +
+                              to_string(threads) + " threads (" +
+                              to_string(unreachable) + " unreachable pairs)");
+        assert_true(table.at(2, 4) == 0, "Origin equal to destination is 0");
+    }
+
+    DistanceTable empty = many_to_many(ch, {}, destinations, 2);
+    assert_true(empty.rows == 0 && empty.cols == 8 && empty.data.empty(),
+                "No origins gives an empty table");
+}
+
+void test_matrix_file() {
+    cout << "\n=== Test Matrix File ===" << endl;
+    DistanceTable table;
+    table.rows = 2;
+    table.cols = 3;
+    table.data = {0.0, 1.5, INF, 2.25, INF, 7.0};
+    string path = "test_many_to_many.bin";
+    assert_true(write_matrix(path, table), "Matrix written");
+
+    FILE* f = fopen(path.c_str(), "rb");
+    char magic[4];
+    int32_t dims[2];
+    vector<double> values(6);
+    bool ok = f && fread(magic, 1, 4, f) == 4 &&
+              fread(dims, sizeof(int32_t), 2, f) == 2 &&
+              fread(values.data(), sizeof(double), 6, f) == 6 &&
+              fgetc(f) == EOF;
+    if (f)
+        fclose(f);
+    remove(path.c_str());
+    assert_true(ok && memcmp(magic, "BMTX", 4) == 0 && dims[0] == 2 &&
+                    dims[1] == 3,
+                "Header holds magic and dimensions");
+    assert_true(values == table.data, "Values are row-major, INF kept");
+}
+
+int main() {
+    cout << "Starting Many-to-Many Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_table();
+    test_matrix_file();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "dijkstra.h"
+#include "test_graphs.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+static bool in_category(const vector<uint64_t>& bits, int v) {
+    return bits.empty() || (bits[v >> 6] >> (v & 63)) & 1;
+}
+
+// The k nearest matching nodes from a full Dijkstra, ties by id.
+static vector<Neighbor> reference(const vector<double>& dist, int k,
+                                  const vector<uint64_t>& bits,
+                                  double bound = INF) {
+    vector<Neighbor> all;
+    for (int v = 0; v < (int)dist.size(); ++v)
+        if (dist[v] < bound && in_category(bits, v))
+            all.push_back({v, dist[v]});
+    sort(all.begin(), all.end(), [](const Neighbor& a, const Neighbor& b) {
+        return a.dist != b.dist ? a.dist < b.dist : a.node < b.node;
+    });
+    if ((int)all.size() > k)
+        all.resize(k);
+    return all;
+}
+
+static bool same(const vector<Neighbor>& a, const vector<Neighbor>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i)
+        if (a[i].node != b[i].node || a[i].dist != b[i].dist)
+            return false;
+    return true;
+}
+
+void test_nearest(bool integral) {
+    cout << "\n=== Test k Nearest (" << (integral ? "integer" : "real")
+         << " weights) ===" << endl;
+    int n = 20000;
+    auto adj = random_graph(n, 60000, integral ? 6 : 7, integral);
+    CsrGraph csr = build_csr(n, adj);
+
+    // Every 50th node is a point of interest.
+    vector<uint64_t> pois((n + 63) / 64, 0);
+    for (int v = 0; v < n; v += 50)
+        pois[v >> 6] |= 1ULL << (v & 63);
+
+    for (int source : {0, 17, 4321}) {
+        vector<double> dist = dijkstra(n, adj, source);
+        for (int k : {1, 5, 100, 5000}) {
+            string mode = "(source " + to_string(source) + ", k " +
+                          to_string(k) + ")";
+            int rounds = 0;
+            auto got = nearest_k(n, adj, source, k, nullptr, SsspOptions(),
+                                 &rounds);
+            assert_true(same(got, reference(dist, k, {})),
+                        "Nearest nodes match Dijkstra " + mode + ", " +
+                            to_string(rounds) + " rounds");
+            assert_true(same(nearest_k(n, adj, source, k, pois.data()),
+                             reference(dist, k, pois)),
+                        "Category filter respected " + mode);
+            assert_true(same(nearest_k(csr.view(), source, k, pois.data()),
+                             reference(dist, k, pois)),
+                        "CSR graph gives the same answer " + mode);
+        }
+    }
+}
+
+void test_limits() {
+    cout << "\n=== Test Radius and Reachability ===" << endl;
+    int n = 5000;
+    auto adj = random_graph(n, 15000, 8, false);
+    vector<double> dist = dijkstra(n, adj, 0);
+    size_t reachable = 0;
+    for (double d : dist)
+        reachable += d != INF;
+
+    auto all = nearest_k(n, adj, 0, n + 10);
+    assert_true(all.size() == reachable && same(all, reference(dist, n, {})),
+                "Asking for more than exist returns every reachable node");
+
+    SsspOptions opts;
+    opts.bound = 15.0;
+    opts.threads = 2;
+    opts.strict = true;
+    assert_true(same(nearest_k(n, adj, 0, 1000, nullptr, opts),
+                     reference(dist, 1000, {}, 15.0)),
+                "Radius caps the answers");
+
+    vector<uint64_t> none((n + 63) / 64, 0);
+    assert_true(nearest_k(n, adj, 0, 3, none.data()).empty(),
+                "Empty category finds nothing");
+    assert_true(nearest_k(n, adj, 0, 0).empty(), "k = 0 finds nothing");
+
+    // Queries reuse label arrays across graphs with the same node count.
+    auto other = random_graph(n, 15000, 9);
+    assert_true(same(nearest_k(n, other, 3, 200),
+                     reference(dijkstra(n, other, 3), 200, {})),
+                "Another graph of the same size starts from clean labels");
+}
+
+int main() {
+    cout << "Starting Nearest Query Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_nearest(false);
+    test_nearest(true);
+    test_limits();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
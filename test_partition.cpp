@@ -0,0 +1,100 @@
+#include "partition.h"
+#include "test_graphs.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+// The layout is a permutation whose parts are the contiguous id ranges
+// given by part_start.
+static bool well_formed(const Partition& p, int n, int parts) {
+    if (p.parts != parts || (int)p.part_start.size() != parts + 1 ||
+        (int)p.order.size() != n || p.part_start[0] != 0 ||
+        p.part_start[parts] != n)
+        return false;
+    for (int i = 0; i < parts; ++i) {
+        if (p.part_start[i] > p.part_start[i + 1])
+            return false;
+        for (int id = p.part_start[i]; id < p.part_start[i + 1]; ++id) {
+            int v = p.order[id];
+            if (v < 0 || v >= n || p.new_id[v] != id || p.part[v] != i)
+                return false;
+        }
+    }
+    return true;
+}
+
+void test_more_parts_than_nodes() {
+    cout << "\n=== Test More Parts Than Nodes ===" << endl;
+    for (int n = 1; n <= 5; ++n) {
+        vector<vector<Edge>> path(n);
+        for (int u = 0; u + 1 < n; ++u)
+            path[u].push_back({u + 1, 1.0});
+        for (int parts : {2, 3, 8, 16}) {
+            Partition p = partition_graph(n, path, parts);
+            assert_true(well_formed(p, n, parts),
+                        to_string(n) + " nodes in " + to_string(parts) +
+                            " parts");
+        }
+    }
+}
+
+void test_balanced() {
+    cout << "\n=== Test Balanced Parts ===" << endl;
+    int n = 4000;
+    auto adj = random_graph(n, 16000, 1);
+    for (int parts : {1, 7, 16}) {
+        Partition p = partition_graph(n, adj, parts);
+        bool balanced = true;
+        for (int i = 0; i < parts; ++i) {
+            int size = p.part_start[i + 1] - p.part_start[i];
+            balanced = balanced && size >= n / parts - 1 &&
+                       size <= n / parts + 1;
+        }
+        assert_true(well_formed(p, n, parts) && balanced,
+                    to_string(parts) + " parts are balanced");
+    }
+    assert_true(partition_graph(n, adj, 1).cut_edges == 0,
+                "A single part cuts nothing");
+}
+
+void test_permute() {
+    cout << "\n=== Test Permuted Graph ===" << endl;
+    int n = 300;
+    auto adj = random_graph(n, 1200, 2);
+    Partition p = partition_graph(n, adj, 4);
+    auto out = permute_graph(adj, p.new_id);
+    bool same = true;
+    for (int u = 0; u < n; ++u) {
+        const auto& row = out[p.new_id[u]];
+        same = same && row.size() == adj[u].size();
+        for (size_t i = 0; same && i < row.size(); ++i)
+            same = row[i].to == p.new_id[adj[u][i].to] &&
+                   row[i].weight == adj[u][i].weight;
+    }
+    assert_true(same, "Edges are relabeled by new_id");
+}
+
+int main() {
+    cout << "Starting Partition Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_more_parts_than_nodes();
+    test_balanced();
+    test_permute();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
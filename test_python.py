@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""Tests of the bmssp extension module (needs it on PYTHONPATH)."""
+
+import math
+import sys
+import threading
+from array import array
+
+import bmssp
+
+
+def assert_true(condition, message):
+    if not condition:
+        print(f"FAILED: {message}", file=sys.stderr)
+        sys.exit(1)
+    print(f"PASSED: {message}")
+
+
+# 0 -> 1 (1), 0 -> 2 (4), 1 -> 2 (2), 2 -> 3 (1), 1 -> 3 (7); node 4 is
+# unreachable.
+OFFSETS = array("q", [0, 2, 4, 5, 5, 5])
+TARGETS = array("i", [1, 2, 2, 3, 3])
+WEIGHTS = array("d", [1, 4, 2, 7, 1])
+
+
+def test_solve():
+    print("\n=== Test Solve ===")
+    g = bmssp.Graph(OFFSETS, TARGETS, WEIGHTS)
+    assert_true(g.node_count == 5 and g.edge_count == 5, "Graph wraps the arrays")
+    dist = g.solve(0)
+    assert_true(list(dist)[:4] == [0, 1, 3, 4] and math.isinf(dist[4]),
+                "Distances are correct")
+    view = memoryview(dist)
+    assert_true(view.format == "d" and view.shape == (5,) and view[2] == 3,
+                "Distances exported through the buffer protocol")
+    dist, parents = g.solve(0, parents=True)
+    assert_true(list(parents) == [-1, 0, 1, 2, -1], "Shortest path tree is correct")
+    dist = g.solve(0, bound=3.5, threads=2, strict=True)
+    assert_true(dist[2] == 3 and math.isinf(dist[3]), "Options honoured")
+
+
+def test_validation():
+    print("\n=== Test Validation ===")
+    for args, message in [
+        ((array("i", [0, 1]), TARGETS, WEIGHTS), "Wrong offset type rejected"),
+        ((OFFSETS, array("i", [1, 2, 2, 3, 9]), WEIGHTS), "Target out of range rejected"),
+        ((OFFSETS, TARGETS, array("d", [1, 4, 2, -7, 1])), "Negative weight rejected"),
+        ((OFFSETS, TARGETS[:3], WEIGHTS), "Short target array rejected"),
+    ]:
+        try:
+            bmssp.Graph(*args)
+            ok = False
+        except (TypeError, ValueError):
+            ok = True
+        assert_true(ok, message)
+    g = bmssp.Graph(OFFSETS, TARGETS, WEIGHTS)
+    try:
+        g.solve(5)
+        ok = False
+    except ValueError:
+        ok = True
+    assert_true(ok, "Source out of range rejected")
+    try:
+        OFFSETS.append(5)
+        ok = False
+    except BufferError:
+        ok = True
+    assert_true(ok, "Arrays are pinned while the graph is alive")
+
+
+def test_threads():
+    print("\n=== Test Concurrent Solves ===")
+    n = 2000
+    offsets = array("q", [0])
+    targets = array("i")
+    weights = array("d")
+    for u in range(n):
+        for k in (1, 7, 31):
+            targets.append((u * k + 1) % n)
+            weights.append(1 + (u * k) % 5)
+        offsets.append(len(targets))
+    g = bmssp.Graph(offsets, targets, weights)
+    expected = [list(g.solve(s)) for s in range(4)]
+    results = [None] * 4
+
+    def run(s):
+        results[s] = list(g.solve(s))
+
+    workers = [threading.Thread(target=run, args=(s,)) for s in range(4)]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    assert_true(results == expected, "Solves from several threads agree")
+
+
+def main():
+    print("Starting Python Binding Tests...")
+    print("=======================================")
+    test_solve()
+    test_validation()
+    test_threads()
+    print("\n=======================================")
+    print("ALL TESTS PASSED!")
+    print("=======================================")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,172 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "graph.h"
+#include "landmarks.h"
+#include "snapshot.h"
+#include "test_graphs.h"
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static bool same_graph(const vector<vector<Edge>>& a,
+                       const vector<vector<Edge>>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t u = 0; u < a.size(); ++u) {
+        if (a[u].size() != b[u].size())
+            return false;
+        for (size_t i = 0; i < a[u].size(); ++i)
+            if (a[u][i].to != b[u][i].to || a[u][i].weight != b[u][i].weight)
+                return false;
+    }
+    return true;
+}
+
+static const int N = 300;
+static const string PATH = "test_snapshot.snap";
+
+// Writes a snapshot of the test graph with its transpose, two landmarks and
+// a tool-specific array.
+static void write_test_snapshot(const vector<vector<Edge>>& adj,
+                                const Landmarks& lm,
+                                const vector<int32_t>& extra) {
+    CsrGraph fwd = build_csr(N, adj);
+    CsrGraph rev = build_csr(N, reverse_graph(N, adj));
+    SnapshotWriter writer;
+    writer.n = N;
+    writer.m = fwd.view().edge_count();
+    writer.source = 5;
+    writer.add_graph("graph", fwd.view());
+    writer.add_graph("reverse", rev.view());
+    writer.add_landmarks(lm);
+    writer.add("tool.labels", extra.data(), extra.size());
+    string error;
+    assert_true(writer.write(PATH, error), "Snapshot written");
+}
+
+void test_round_trip() {
+    cout << "\n=== Test Snapshot Round Trip ===" << endl;
+    vector<vector<Edge>> adj = random_graph(N, 1500, 1);
+    vector<vector<Edge>> radj = reverse_graph(N, adj);
+    Landmarks lm = select_landmarks(N, adj, radj, 2);
+    vector<int32_t> extra(N);
+    for (int v = 0; v < N; ++v)
+        extra[v] = v * 7 % 11;
+    write_test_snapshot(adj, lm, extra);
+
+    MappedSnapshot snap;
+    string error;
+    assert_true(snap.open(PATH, error), "Snapshot mapped and verified");
+    assert_true(snap.header.n == N && snap.header.source == 5,
+                "Header keeps node count and source");
+
+    CsrView view;
+    assert_true(snap.graph("graph", view) &&
+                    same_graph(csr_to_adjacency(view), adj),
+                "Mapped graph matches the input");
+    assert_true(solve_sssp(view, 5) == solve_sssp(N, adj, 5),
+                "Solver runs on the mapped arrays");
+
+    GraphInput g;
+    assert_true(load_snapshot_graph(snap, true, g, error) &&
+                    same_graph(g.adj, adj) && same_graph(g.radj, radj),
+                "Adjacency lists rebuilt from the snapshot");
+
+    Landmarks loaded;
+    assert_true(snap.landmarks(loaded) && loaded.ids == lm.ids &&
+                    loaded.from == lm.from && loaded.to == lm.to,
+                "Landmark tables restored");
+
+    const SnapshotSection* labels = snap.find("tool.labels", SNAPSHOT_INT32);
+    assert_true(labels && labels->count == (uint64_t)N &&
+                    vector<int32_t>((const int32_t*)snap.data(*labels),
+                                    (const int32_t*)snap.data(*labels) + N) ==
+                        extra,
+                "Tool-specific array kept");
+    assert_true(!snap.find("tool.labels", SNAPSHOT_FLOAT64) &&
+                    !snap.find("missing", SNAPSHOT_INT32),
+                "Lookup checks name and type");
+    snap.close();
+    remove(PATH.c_str());
+}
+
+void test_corruption() {
+    cout << "\n=== Test Snapshot Validation ===" << endl;
+    vector<vector<Edge>> adj = random_graph(N, 1500, 2);
+    write_test_snapshot(adj, Landmarks(), {});
+
+    // Flip one byte in the middle of the data.
+    FILE* f = fopen(PATH.c_str(), "r+b");
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, size / 2, SEEK_SET);
+    int c = fgetc(f);
+    fseek(f, size / 2, SEEK_SET);
+    fputc(c ^ 1, f);
+    fclose(f);
+
+    MappedSnapshot snap;
+    string error;
+    assert_true(!snap.open(PATH, error) &&
+                    error.find("checksum") != string::npos,
+                "Corrupted data detected");
+    assert_true(snap.open(PATH, error, false),
+                "Opens without data verification");
+    snap.close();
+
+    // Unknown versions are refused.
+    f = fopen(PATH.c_str(), "r+b");
+    fseek(f, 4, SEEK_SET);
+    uint32_t version = SNAPSHOT_VERSION + 1;
+    fwrite(&version, sizeof(version), 1, f);
+    fclose(f);
+    assert_true(!snap.open(PATH, error, false), "Newer version rejected");
+
+    // A consistent file may still carry arrays that are not a valid graph.
+    CsrGraph bad = build_csr(N, adj);
+    bad.targets[bad.offsets[1]] = N + 7;
+    SnapshotWriter writer;
+    writer.n = N;
+    writer.m = bad.view().edge_count();
+    writer.add_graph("graph", bad.view());
+    assert_true(writer.write(PATH, error), "Snapshot with a bad target written");
+    CsrView view;
+    assert_true(snap.open(PATH, error) && !snap.graph("graph", view) &&
+                    view.n == 0,
+                "Out-of-range target rejected by the graph view");
+    GraphInput g;
+    assert_true(!load_snapshot_graph(snap, false, g, error),
+                "Out-of-range target rejected by the loader");
+    snap.close();
+
+    f = fopen(PATH.c_str(), "wb");
+    fputs("BMSN", f);
+    fclose(f);
+    assert_true(!snap.open(PATH, error), "Truncated file rejected");
+    remove(PATH.c_str());
+}
+
+int main() {
+    cout << "Starting Snapshot Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_round_trip();
+    test_corruption();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
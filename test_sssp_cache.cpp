@@ -0,0 +1,176 @@
+#include "bmssp.h"
+#include "parallel.h"
+#include "sssp_cache.h"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static vector<vector<Edge>> make_chain(int n) {
+    vector<vector<Edge>> adj(n);
+    for (int i = 0; i + 1 < n; ++i)
+        adj[i].push_back({i + 1, 1.0 + i});
+    return adj;
+}
+
+void test_hit_and_miss() {
+    cout << "\n=== Test Hit And Miss ===" << endl;
+    int n = 50;
+    auto adj = make_chain(n);
+    uint64_t fp = graph_fingerprint(n, adj);
+    SsspCache cache(1 << 20);
+    double inf = numeric_limits<double>::infinity();
+
+    auto first = cache.solve(n, adj, fp, 0, inf);
+    auto second = cache.solve(n, adj, fp, 0, inf);
+    assert_true(cache.stats.misses == 1, "First query misses");
+    assert_true(cache.stats.hits == 1, "Repeated query hits");
+    assert_true(first == second, "Cached result equals computed result");
+    assert_true(first == solve_sssp(n, adj, 0), "Cached result matches solver");
+    assert_true(cache.used_bytes - sizeof(SsspCache::Entry) <
+                    n * sizeof(double),
+                "Entry is smaller than the dense vector");
+
+    cache.solve(n, adj, fp, 0, 10.0);
+    assert_true(cache.stats.misses == 2, "Different bound is a separate key");
+}
+
+void test_real_weights() {
+    cout << "\n=== Test Real Weights ===" << endl;
+    // Weights with no exact representation at the cache resolution.
+    int n = 200;
+    vector<vector<Edge>> adj(n);
+    for (int i = 0; i + 1 < n; ++i) {
+        adj[i].push_back({i + 1, 0.1 + i / 3.0});
+        if (i + 7 < n)
+            adj[i].push_back({i + 7, 2.718281828 * (i % 5 + 1)});
+    }
+    uint64_t fp = graph_fingerprint(n, adj);
+    SsspCache cache(1 << 20);
+    double inf = numeric_limits<double>::infinity();
+
+    auto miss = cache.solve(n, adj, fp, 0, inf);
+    auto hit = cache.solve(n, adj, fp, 0, inf);
+    assert_true(cache.stats.hits == 1, "Second query hits");
+    assert_true(miss == hit, "Miss and hit return identical values");
+
+    auto exact = solve_sssp(n, adj, 0);
+    bool close = true;
+    for (int v = 0; v < n; ++v)
+        close = close && abs(hit[v] - exact[v]) <= cache.resolution;
+    assert_true(close, "Cached values are within the resolution");
+}
+
+void test_bounded_solve() {
+    cout << "\n=== Test Bounded Solve ===" << endl;
+    int n = 10;
+    auto adj = make_chain(n);
+    auto dist = solve_sssp(n, adj, 0, 6.5);
+    // Chain distances: 0, 1, 3, 6, 10, ...
+    assert_true(dist[3] == 6.0, "Node below bound is solved");
+    assert_true(dist[4] == numeric_limits<double>::infinity(),
+                "Node at or above bound is INF");
+}
+
+void test_lru_eviction() {
+    cout << "\n=== Test LRU Eviction ===" << endl;
+    int n = 100;
+    auto adj = make_chain(n);
+    uint64_t fp = graph_fingerprint(n, adj);
+    double inf = numeric_limits<double>::infinity();
+    auto entry_bytes = [&](int s) {
+        CompressedDistances cd(solve_sssp(n, adj, s), 1e-6);
+        return sizeof(SsspCache::Entry) + cd.bytes();
+    };
+    // Room for exactly the first two entries.
+    SsspCache cache(entry_bytes(0) + entry_bytes(1));
+
+    cache.solve(n, adj, fp, 0, inf);
+    cache.solve(n, adj, fp, 1, inf);
+    cache.solve(n, adj, fp, 0, inf); // touch 0, so 1 becomes LRU
+    cache.solve(n, adj, fp, 2, inf); // evicts 1
+    assert_true(cache.stats.evictions == 1, "One eviction");
+    assert_true(cache.used_bytes <= cache.budget_bytes, "Within budget");
+
+    vector<double> out;
+    assert_true(cache.lookup({fp, 0, inf}, out), "Recently used entry kept");
+    assert_true(!cache.lookup({fp, 1, inf}, out), "LRU entry evicted");
+}
+
+void test_invalidation() {
+    cout << "\n=== Test Invalidation ===" << endl;
+    int n = 20;
+    auto adj = make_chain(n);
+    uint64_t fp = graph_fingerprint(n, adj);
+    SsspCache cache(1 << 20);
+    double inf = numeric_limits<double>::infinity();
+    cache.solve(n, adj, fp, 0, inf);
+
+    adj[0][0].weight = 5.0;
+    uint64_t fp2 = graph_fingerprint(n, adj);
+    assert_true(fp != fp2, "Weight change alters fingerprint");
+
+    cache.solve(n, adj, fp2, 0, inf);
+    cache.invalidate(fp);
+    assert_true(cache.size() == 1, "Only the stale graph's entry is dropped");
+    vector<double> out;
+    assert_true(cache.lookup({fp2, 0, inf}, out) && out[1] == 5.0,
+                "Entry for current graph survives");
+    cache.clear();
+    assert_true(cache.size() == 0 && cache.used_bytes == 0, "Clear empties");
+}
+
+void test_concurrent_solve() {
+    cout << "\n=== Test Concurrent Solve ===" << endl;
+    int n = 300;
+    auto adj = make_chain(n);
+    uint64_t fp = graph_fingerprint(n, adj);
+    SsspCache cache(1 << 20);
+    double inf = numeric_limits<double>::infinity();
+    vector<vector<double>> results(64);
+    vector<char> hits(64);
+    parallel_for(64, 4, [&](int, int i) {
+        bool hit = false;
+        results[i] = cache.solve(n, adj, fp, i % 8, inf, &hit);
+        hits[i] = hit;
+    });
+    int reported = 0;
+    bool same = true;
+    for (int i = 0; i < 64; ++i) {
+        reported += hits[i];
+        same = same && results[i] == results[i % 8];
+    }
+    assert_true(cache.stats.hits + cache.stats.misses == 64 &&
+                    (uint64_t)reported == cache.stats.hits,
+                "Every query is counted once as a hit or a miss");
+    assert_true(cache.size() == 8 && same,
+                "Concurrent queries agree per source");
+}
+
+int main() {
+    cout << "Starting SSSP Cache Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_hit_and_miss();
+    test_real_weights();
+    test_bounded_solve();
+    test_lru_eviction();
+    test_invalidation();
+    test_concurrent_solve();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
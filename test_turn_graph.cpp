@@ -0,0 +1,209 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "dijkstra.h"
+#include "test_graphs.h"
+#include "turn_graph.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <queue>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+typedef map<tuple<int, int, int>, double> TurnMap;
+
+// Reference: Dijkstra over (previous vertex, vertex) states with turn costs
+// looked up per step, without building an expanded graph.
+static vector<double> turn_dijkstra(int n, const vector<vector<Edge>>& adj,
+                                    const TurnMap& turns,
+                                    double u_turn_penalty, int source) {
+    typedef tuple<double, int, int> Item; // cost, previous vertex, vertex
+    map<pair<int, int>, double> best;
+    priority_queue<Item, vector<Item>, greater<Item>> pq;
+    vector<double> dist(n, INF);
+    dist[source] = 0;
+    for (const Edge& e : adj[source])
+        pq.push(Item(e.weight, source, e.to));
+    while (!pq.empty()) {
+        double d;
+        int u, v;
+        tie(d, u, v) = pq.top();
+        pq.pop();
+        auto it = best.find({u, v});
+        if (it != best.end() && it->second <= d)
+            continue;
+        best[{u, v}] = d;
+        dist[v] = min(dist[v], d);
+        for (const Edge& e : adj[v]) {
+            double p = e.to == u ? u_turn_penalty : 0;
+            auto t = turns.find(make_tuple(u, v, e.to));
+            if (t != turns.end())
+                p = t->second;
+            if (p != INF)
+                pq.push(Item(d + e.weight + p, v, e.to));
+        }
+    }
+    return dist;
+}
+
+void test_layout() {
+    cout << "\n=== Test Expansion Layout ===" << endl;
+    int n = 400;
+    auto adj = random_graph(n, 1600, 1);
+    EdgeBasedGraph eg = build_edge_based(n, adj, {});
+    assert_true(eg.m == 1600 && eg.graph.n == eg.m + n,
+                "One node per edge plus one entry node per vertex");
+    assert_true(valid_csr(eg.graph.view()), "Expansion is a valid CSR graph");
+    assert_true(eg.entry_node(7) == 1607, "Entry nodes follow edge nodes");
+
+    bool heads_ok = true;
+    for (int u = 0; u < n; ++u)
+        for (size_t i = 0; i < adj[u].size(); ++i)
+            heads_ok = heads_ok &&
+                       eg.edge_head[eg.edge_start[u] + i] == adj[u][i].to;
+    assert_true(heads_ok, "Edges are numbered row by row");
+}
+
+void test_without_turn_costs() {
+    cout << "\n=== Test No Turn Costs ===" << endl;
+    int n = 2000;
+    auto adj = random_graph(n, 8000, 2, true);
+    EdgeBasedGraph eg = build_edge_based(n, adj, {});
+    bool dijkstra_ok = true, bmssp_ok = true;
+    for (int source : {0, 11, n - 1}) {
+        vector<double> exact = dijkstra(n, adj, source);
+        int entry = eg.entry_node(source);
+        dijkstra_ok = dijkstra_ok &&
+                      vertex_distances(eg, source,
+                                       dijkstra(eg.graph.view(), entry)) ==
+                          exact;
+        bmssp_ok = bmssp_ok &&
+                   vertex_distances(eg, source,
+                                    solve_sssp(eg.graph.view(), entry)) ==
+                       exact;
+    }
+    assert_true(dijkstra_ok, "Edge-based Dijkstra matches plain Dijkstra");
+    assert_true(bmssp_ok, "Edge-based BMSSP matches plain Dijkstra");
+}
+
+void test_random_turn_costs() {
+    cout << "\n=== Test Random Turn Costs ===" << endl;
+    int n = 600;
+    auto adj = random_graph(n, 2400, 3, true);
+    mt19937 rng(3);
+    vector<TurnCost> turns;
+    TurnMap lookup;
+    for (int u = 0; u < n; ++u) {
+        for (const Edge& in : adj[u]) {
+            for (const Edge& out : adj[in.to]) {
+                unsigned r = rng() % 8;
+                if (r > 1)
+                    continue;
+                double p = r == 0 ? INF : (double)(rng() % 5);
+                turns.push_back({u, in.to, out.to, p});
+                lookup[make_tuple(u, in.to, out.to)] = p;
+            }
+        }
+    }
+    double u_turn = 3;
+    EdgeBasedGraph eg = build_edge_based(n, adj, turns, u_turn);
+
+    bool same = true;
+    int unreachable = 0;
+    for (int source : {0, 5, n / 2}) {
+        vector<double> exact = turn_dijkstra(n, adj, lookup, u_turn, source);
+        for (double d : exact)
+            unreachable += d == INF;
+        vector<double> edge_dist =
+            solve_sssp(eg.graph.view(), eg.entry_node(source));
+        same = same && vertex_distances(eg, source, edge_dist) == exact;
+    }
+    assert_true(same, "Matches a per-step turn Dijkstra with " +
+                          to_string(turns.size()) + " turn costs (" +
+                          to_string(unreachable) + " unreachable)");
+}
+
+void test_forbidden_turn() {
+    cout << "\n=== Test Forbidden Turn ===" << endl;
+    // 0 -> 1 -> 2 is short, but the turn at 1 is forbidden; the detour
+    // 0 -> 1 -> 3 -> 2 costs more.
+    int n = 4;
+    vector<vector<Edge>> adj(n);
+    adj[0].push_back({1, 1.0});
+    adj[1].push_back({2, 1.0});
+    adj[1].push_back({3, 1.0});
+    adj[1].push_back({0, 1.0});
+    adj[3].push_back({2, 5.0});
+    EdgeBasedGraph eg = build_edge_based(n, adj, {{0, 1, 2, INF}});
+    vector<double> dist = vertex_distances(
+        eg, 0, dijkstra(eg.graph.view(), eg.entry_node(0)));
+    assert_true(dist[2] == 7.0, "Forbidden turn forces the detour");
+
+    eg = build_edge_based(n, adj, {{0, 1, 2, 10.0}});
+    dist = vertex_distances(eg, 0, dijkstra(eg.graph.view(), eg.entry_node(0)));
+    assert_true(dist[2] == 7.0, "Penalty above the detour is avoided");
+
+    eg = build_edge_based(n, adj, {{0, 1, 2, 2.0}});
+    dist = vertex_distances(eg, 0, dijkstra(eg.graph.view(), eg.entry_node(0)));
+    assert_true(dist[2] == 4.0, "Penalty below the detour is paid");
+
+    // Paths without a u-turn do not pay the u-turn penalty.
+    eg = build_edge_based(n, adj, {}, 100.0);
+    dist = vertex_distances(eg, 0, dijkstra(eg.graph.view(), eg.entry_node(0)));
+    assert_true(dist[0] == 0 && dist[2] == 2.0, "U-turn penalty off the path");
+}
+
+static bool parse(const string& text, vector<TurnCost>& turns) {
+    string path = "test_turn_graph.txt";
+    ofstream(path) << text;
+    turns.clear();
+    bool ok = read_turn_costs(path.c_str(), turns);
+    remove(path.c_str());
+    return ok;
+}
+
+void test_read_turn_costs() {
+    cout << "\n=== Test Reading Turn Costs ===" << endl;
+    vector<TurnCost> turns;
+    assert_true(parse("0 1 2 inf\n\n3 4 5 2.5\n", turns) &&
+                    turns.size() == 2 && turns[0].penalty == INF &&
+                    turns[1].to == 5 && turns[1].penalty == 2.5,
+                "Finite and infinite penalties are read");
+    assert_true(!parse("0 1 2 nan\n", turns), "nan penalty is rejected");
+    assert_true(!parse("0 1 2 -1\n", turns), "Negative penalty is rejected");
+    assert_true(!parse("0 1 2\n", turns), "Missing penalty is rejected");
+    assert_true(!parse("0 1 2 3x\n", turns), "Trailing garbage is rejected");
+    assert_true(!read_turn_costs("no_such_turns.txt", turns),
+                "Missing file is reported");
+}
+
+int main() {
+    cout << "Starting Turn Graph Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_layout();
+    test_without_turn_costs();
+    test_random_turn_costs();
+    test_forbidden_turn();
+    test_read_turn_costs();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "bmssp.h"
+#include "csr_graph.h"
+#include "dijkstra.h"
+#include "test_graphs.h"
+#include <iostream>
+#include <vector>
+
+using namespace std;
+
+// Test utilities
+void assert_true(bool condition, const string& message) {
+    if (!condition) {
+        cerr << "FAILED: " << message << endl;
+        exit(1);
+    }
+    cout << "PASSED: " << message << endl;
+}
+
+static const double INF = numeric_limits<double>::infinity();
+
+// Visits in call order.
+struct Recorder {
+    vector<pair<vertex_t, double>> visits;
+    size_t limit = SIZE_MAX;
+
+    SettledVisitor visitor() {
+        return [this](vertex_t v, double d) {
+            visits.push_back({v, d});
+            return visits.size() < limit;
+        };
+    }
+};
+
+// Each node visited at most once, with its exact distance, the source first.
+static bool visits_exact(const Recorder& rec, int n, int source,
+                         const vector<double>& exact) {
+    vector<char> seen(n, 0);
+    for (const auto& visit : rec.visits) {
+        if (seen[visit.first] || visit.second != exact[visit.first])
+            return false;
+        seen[visit.first] = 1;
+    }
+    return !rec.visits.empty() && rec.visits[0].first == source;
+}
+
+void test_full_stream(bool integral) {
+    cout << "\n=== Test Full Stream (" << (integral ? "integer" : "real")
+         << " weights) ===" << endl;
+    int n = 30000;
+    auto adj = random_graph(n, 120000, integral ? 3 : 4, integral);
+    vector<double> exact = dijkstra(n, adj, 0);
+    size_t reached = 0;
+    for (double d : exact)
+        reached += d != INF;
+    CsrGraph csr = build_csr(n, adj);
+
+    for (int threads : {0, 2}) {
+        for (bool strict : {false, true}) {
+            string mode = "(threads " + to_string(threads) +
+                          (strict ? ", strict)" : ")");
+            SsspOptions opts;
+            opts.threads = threads;
+            opts.strict = strict;
+            Recorder rec;
+            SolveStatus status =
+                visit_sssp(n, adj, 0, rec.visitor(), opts);
+            assert_true(status == SOLVE_COMPLETE &&
+                            rec.visits.size() == reached &&
+                            visits_exact(rec, n, 0, exact),
+                        "Every reached node visited once, exactly " + mode);
+
+            Recorder on_csr;
+            visit_sssp(csr.view(), 0, on_csr.visitor(), opts);
+            assert_true(on_csr.visits == rec.visits,
+                        "CSR graph streams the same visits " + mode);
+        }
+    }
+
+    // A bounded solve only visits nodes below the bound.
+    double bound = 12.0;
+    SsspOptions opts;
+    opts.bound = bound;
+    Recorder rec;
+    opts.on_settled = rec.visitor();
+    vector<double> dist = solve_sssp(n, adj, 0, opts);
+    size_t inside = 0;
+    for (double d : exact)
+        inside += d < bound;
+    assert_true(rec.visits.size() == inside &&
+                    visits_exact(rec, n, 0, exact),
+                "Bounded solve visits exactly the ball");
+    bool dense_matches = true;
+    for (const auto& visit : rec.visits)
+        dense_matches = dense_matches && dist[visit.first] == visit.second;
+    assert_true(dense_matches, "Visits agree with the dense result");
+}
+
+void test_early_stop() {
+    cout << "\n=== Test Early Stop ===" << endl;
+    int n = 30000;
+    auto adj = random_graph(n, 120000, 5, false);
+    vector<double> exact = dijkstra(n, adj, 0);
+
+    for (size_t limit : {1, 100, 5000}) {
+        Recorder rec;
+        rec.limit = limit;
+        SolveStatus status;
+        vector<vertex_t> parents;
+        SsspOptions opts;
+        opts.status = &status;
+        opts.parents = &parents;
+        opts.on_settled = rec.visitor();
+        vector<double> dist = solve_sssp(n, adj, 0, opts);
+        bool partial_exact = true;
+        for (int v = 0; v < n; ++v)
+            partial_exact = partial_exact &&
+                            (dist[v] == INF || dist[v] == exact[v]);
+        bool visited_reported = true;
+        for (const auto& visit : rec.visits)
+            visited_reported = visited_reported && dist[visit.first] != INF;
+        string mode = "(limit " + to_string(limit) + ")";
+        assert_true(status == SOLVE_STOPPED && rec.visits.size() == limit &&
+                        visits_exact(rec, n, 0, exact),
+                    "Visitor stops the solve " + mode);
+        assert_true(partial_exact && visited_reported,
+                    "Partial result keeps the visited nodes " + mode);
+    }
+}
+
+int main() {
+    cout << "Starting Visitor Tests..." << endl;
+    cout << "=======================================" << endl;
+
+    test_full_stream(false);
+    test_full_stream(true);
+    test_early_stop();
+
+    cout << "\n=======================================" << endl;
+    cout << "ALL TESTS PASSED!" << endl;
+    cout << "=======================================" << endl;
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include "turn_graph.h"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+namespace {
+
+struct TurnKey {
+    int from, via, to;
+
+    bool operator==(const TurnKey& other) const {
+        return from == other.from && via == other.via && to == other.to;
+    }
+};
+
+struct TurnKeyHash {
+    size_t operator()(const TurnKey& k) const {
+        uint64_t h = (uint64_t)(uint32_t)k.from * 0x9E3779B97F4A7C15ULL;
+        h ^= (uint64_t)(uint32_t)k.via + 0x632BE59BD9B4E019ULL + (h << 6) +
+             (h >> 2);
+        h ^= (uint64_t)(uint32_t)k.to + 0x8CB92BA72F3D8DD7ULL + (h << 6) +
+             (h >> 2);
+        return (size_t)h;
+    }
+};
+
+} // namespace
+
+bool read_turn_costs(const char* path, vector<TurnCost>& turns) {
+    ifstream in(path);
+    if (!in)
+        return false;
+    string line;
+    while (getline(in, line)) {
+        istringstream ls(line);
+        TurnCost t;
+        string penalty;
+        if (!(ls >> t.from))
+            continue; // blank line
+        if (!(ls >> t.via >> t.to >> penalty))
+            return false;
+        char* end = nullptr;
+        t.penalty = strtod(penalty.c_str(), &end);
+        // Written so that nan fails too.
+        if (end == penalty.c_str() || *end != '\0' || !(t.penalty >= 0))
+            return false;
+        turns.push_back(t);
+    }
+    return true;
+}
+
+EdgeBasedGraph build_edge_based(vertex_t n, const vector<vector<Edge>>& adj,
+                                const vector<TurnCost>& turns,
+                                double u_turn_penalty) {
+    const double INF = numeric_limits<double>::infinity();
+    EdgeBasedGraph eg;
+    eg.n = n;
+
+    eg.edge_start.assign(n + 1, 0);
+    for (int u = 0; u < n; ++u)
+        eg.edge_start[u + 1] = eg.edge_start[u] + (edge_t)adj[u].size();
+    eg.m = eg.edge_start[n];
+    if (eg.m + n > numeric_limits<vertex_t>::max())
+        throw overflow_error("edge-based graph has more than 2^31 - 1 nodes");
+    eg.edge_head.resize(eg.m);
+    for (int u = 0; u < n; ++u)
+        for (size_t i = 0; i < adj[u].size(); ++i)
+            eg.edge_head[eg.edge_start[u] + i] = adj[u][i].to;
+
+    unordered_map<TurnKey, double, TurnKeyHash> penalty;
+    penalty.reserve(turns.size());
+    for (const auto& t : turns)
+        penalty[{t.from, t.via, t.to}] = t.penalty;
+    auto turn_penalty = [&](int u, int v, int x) {
+        double p = x == u ? u_turn_penalty : 0;
+        if (!penalty.empty()) {
+            auto it = penalty.find({u, v, x});
+            if (it != penalty.end())
+                p = it->second;
+        }
+        return p;
+    };
+
+    // Edge-node u -> v has one transition per allowed turn onto an edge
+    // leaving v; entry node v has one per edge leaving v. A first pass
+    // sizes the rows, a second fills them.
+    CsrGraph& g = eg.graph;
+    g.n = (vertex_t)(eg.m + n);
+    g.offsets.resize(g.n + 1);
+    g.offsets[0] = 0;
+    for (int u = 0; u < n; ++u) {
+        for (size_t i = 0; i < adj[u].size(); ++i) {
+            int v = adj[u][i].to;
+            edge_t allowed = 0;
+            for (const Edge& next : adj[v])
+                allowed += turn_penalty(u, v, next.to) != INF;
+            edge_t e = eg.edge_start[u] + i;
+            g.offsets[e + 1] = g.offsets[e] + allowed;
+        }
+    }
+    for (int v = 0; v < n; ++v)
+        g.offsets[eg.m + v + 1] = g.offsets[eg.m + v] + (edge_t)adj[v].size();
+
+    g.targets.resize(g.offsets[g.n]);
+    g.weights.resize(g.offsets[g.n]);
+    edge_t pos = 0;
+    for (int u = 0; u < n; ++u) {
+        for (size_t i = 0; i < adj[u].size(); ++i) {
+            int v = adj[u][i].to;
+            for (size_t j = 0; j < adj[v].size(); ++j) {
+                double p = turn_penalty(u, v, adj[v][j].to);
+                if (p == INF)
+                    continue;
+                g.targets[pos] = (vertex_t)(eg.edge_start[v] + j);
+                g.weights[pos] = adj[v][j].weight + p;
+                pos++;
+            }
+        }
+    }
+
+    // Entry nodes: starting at v, any outgoing edge can be taken.
+    for (int v = 0; v < n; ++v) {
+        for (size_t j = 0; j < adj[v].size(); ++j) {
+            g.targets[pos] = (vertex_t)(eg.edge_start[v] + j);
+            g.weights[pos] = adj[v][j].weight;
+            pos++;
+        }
+    }
+    return eg;
+}
+
+vector<double> vertex_distances(const EdgeBasedGraph& eg, vertex_t source,
+                                const vector<double>& edge_dist) {
+    vector<double> dist(eg.n, numeric_limits<double>::infinity());
+    dist[source] = 0;
+    for (edge_t e = 0; e < eg.m; ++e)
+        if (edge_dist[e] < dist[eg.edge_head[e]])
+            dist[eg.edge_head[e]] = edge_dist[e];
+    return dist;
+}
@@ -0,0 +1,51 @@
+#ifndef TURN_GRAPH_H
+#define TURN_GRAPH_H
+
+#include "csr_graph.h"
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Cost of turning from edge from -> via onto edge via -> to. An infinite
+// penalty forbids the turn.
+struct TurnCost {
+    vertex_t from;
+    vertex_t via;
+    vertex_t to;
+    double penalty;
+};
+
+// Reads `from via to penalty` lines; `inf` forbids a turn. Returns false if
+// the file cannot be opened or a line is malformed, negative or `nan`.
+bool read_turn_costs(const char* path, vector<TurnCost>& turns);
+
+// Edge-based expansion of a graph. Node e < m stands for original edge e
+// (numbered row by row: edge_start[u] + index in adj[u]) and carries the
+// cost of arriving over it, including its weight. Node m + v is an entry
+// node for starting a search at vertex v. Transitions e -> f carry f's
+// weight plus the turn penalty. The expansion is stored as CSR, so node ids
+// m + n must fit in vertex_t.
+struct EdgeBasedGraph {
+    vertex_t n = 0;             // original vertex count
+    edge_t m = 0;               // original edge count
+    vector<edge_t> edge_start;  // n + 1 row offsets into edge ids
+    vector<vertex_t> edge_head; // m heads: target vertex of each edge
+    CsrGraph graph;             // m + n nodes
+
+    vertex_t entry_node(vertex_t v) const { return (vertex_t)(m + v); }
+};
+
+// Turns not listed cost nothing; `u_turn_penalty` applies to every
+// u -> v -> u turn not listed explicitly. Throws overflow_error if the
+// expansion has more nodes than vertex_t can number.
+EdgeBasedGraph build_edge_based(vertex_t n, const vector<vector<Edge>>& adj,
+                                const vector<TurnCost>& turns,
+                                double u_turn_penalty = 0);
+
+// Vertex distances from an edge-based solve started at entry_node(source):
+// each vertex takes its cheapest incoming edge-node.
+vector<double> vertex_distances(const EdgeBasedGraph& eg, vertex_t source,
+                                const vector<double>& edge_dist);
+
+#endif // TURN_GRAPH_H
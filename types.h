@@ -1,8 +1,15 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <cstdint>
+
+// Node ids are 32-bit to keep edge arrays compact; edge counts and offsets
+// into edge arrays are 64-bit so graphs may exceed 2^31 edges.
+typedef int32_t vertex_t;
+typedef int64_t edge_t;
+
 struct State {
-    int node_id;
+    vertex_t node_id;
     double cost;
 
     bool operator>(const State& other) const {
@@ -13,7 +20,7 @@ struct State {
 };
 
 struct Edge {
-    int to;
+    vertex_t to;
     double weight;
 };
 
@@ -0,0 +1,395 @@
+#include "bmssp.h"
+#include "compressed_graph.h"
+#include "csr_graph.h"
+#include "dijkstra.h"
+#include "types.h"
+#include "zero_weight.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+// Randomized cross-check of solve_sssp against Dijkstra. Each case draws a
+// graph from one of several families aimed at the weak spots of the
+// algorithm (ties, zero weights, unreachable parts, mixed magnitudes), runs
+// every solver configuration in-process and compares the distances. A
+// failing case is shrunk edge by edge and written in the text input format.
+
+static const double INF = numeric_limits<double>::infinity();
+
+struct Case {
+    int n = 0;
+    int source = 0;
+    vector<tuple<int, int, double>> edges;
+    bool integral = true;
+};
+
+enum Family {
+    FAMILY_RANDOM,
+    FAMILY_TIES,
+    FAMILY_ZERO,
+    FAMILY_DISCONNECTED,
+    FAMILY_HUGE,
+    FAMILY_GRID,
+    FAMILY_CHAINS,
+    FAMILY_COUNT
+};
+
+static const char* family_name(int f) {
+    switch (f) {
+    case FAMILY_RANDOM:
+        return "random";
+    case FAMILY_TIES:
+        return "ties";
+    case FAMILY_ZERO:
+        return "zero";
+    case FAMILY_DISCONNECTED:
+        return "disconnected";
+    case FAMILY_HUGE:
+        return "huge";
+    case FAMILY_GRID:
+        return "grid";
+    default:
+        return "chains";
+    }
+}
+
+static Case generate(int family, int max_n, mt19937_64& rng) {
+    Case c;
+    c.n = uniform_int_distribution<int>(1, max_n)(rng);
+    int n = c.n;
+    auto node = [&]() { return uniform_int_distribution<int>(0, n - 1)(rng); };
+    auto real = [&](double lo, double hi) {
+        return uniform_real_distribution<double>(lo, hi)(rng);
+    };
+    auto integer = [&](int lo, int hi) {
+        return uniform_int_distribution<int>(lo, hi)(rng);
+    };
+    int degree = integer(1, 6);
+    long long m = (long long)n * degree;
+    c.source = node();
+
+    switch (family) {
+    case FAMILY_RANDOM:
+        c.integral = false;
+        for (long long i = 0; i < m; ++i)
+            c.edges.emplace_back(node(), node(), real(0.5, 100.0));
+        break;
+    case FAMILY_TIES:
+        // Few distinct weights: many equal distances and equal-cost paths.
+        for (long long i = 0; i < m; ++i)
+            c.edges.emplace_back(node(), node(), integer(1, 3));
+        break;
+    case FAMILY_ZERO:
+        for (long long i = 0; i < m; ++i)
+            c.edges.emplace_back(node(), node(),
+                                 integer(0, 9) < 4 ? 0 : integer(1, 4));
+        break;
+    case FAMILY_DISCONNECTED: {
+        // Edges stay inside blocks of ids, so only the source's block is
+        // reachable; some nodes have no edges at all.
+        c.integral = false;
+        int parts = min(n, integer(2, 8));
+        for (long long i = 0; i < m; ++i) {
+            int u = node();
+            int block = u * parts / n;
+            int lo = (int)((long long)block * n / parts);
+            int hi = (int)((long long)(block + 1) * n / parts) - 1;
+            c.edges.emplace_back(u, integer(lo, hi), real(1.0, 10.0));
+        }
+        break;
+    }
+    case FAMILY_HUGE:
+        // Weights spanning many orders of magnitude, up to 1e15.
+        for (long long i = 0; i < m; ++i) {
+            double w = integer(0, 3) == 0 ? 1.0 : pow(10.0, integer(1, 15));
+            c.edges.emplace_back(node(), node(), w * integer(1, 9));
+        }
+        break;
+    case FAMILY_GRID: {
+        int side = max(1, (int)sqrt((double)n));
+        c.n = n = side * side;
+        c.source = node();
+        for (int v = 0; v < n; ++v) {
+            int r = v / side, col = v % side;
+            if (col + 1 < side) {
+                c.edges.emplace_back(v, v + 1, integer(1, 4));
+                c.edges.emplace_back(v + 1, v, integer(1, 4));
+            }
+            if (r + 1 < side) {
+                c.edges.emplace_back(v, v + side, integer(1, 4));
+                c.edges.emplace_back(v + side, v, integer(1, 4));
+            }
+        }
+        break;
+    }
+    default:
+        // Long chains with unit weights plus shortcuts: deep recursions and
+        // pulls where every element shares the bound.
+        for (int v = 0; v + 1 < n; ++v)
+            c.edges.emplace_back(v, v + 1, 1);
+        for (int i = 0; i < n / 8; ++i) {
+            int u = node();
+            int v = min(n - 1, u + integer(1, 16));
+            c.edges.emplace_back(u, v, max(0, v - u - integer(0, 1)));
+        }
+        c.source = 0;
+        break;
+    }
+    return c;
+}
+
+static vector<vector<Edge>> adjacency(const Case& c) {
+    vector<vector<Edge>> adj(c.n);
+    for (const auto& e : c.edges)
+        adj[get<0>(e)].push_back({get<1>(e), get<2>(e)});
+    return adj;
+}
+
+static bool same_distance(double a, double b) {
+    if (a == INF || b == INF)
+        return a == b;
+    return fabs(a - b) <= 1e-9 * max(1.0, fabs(b));
+}
+
+// Every reached node other than the source has a predecessor edge that
+// realizes its distance.
+static bool parents_valid(const vector<vector<Edge>>& adj, int source,
+                          const vector<double>& dist,
+                          const vector<vertex_t>& parents) {
+    for (size_t v = 0; v < dist.size(); ++v) {
+        if ((int)v == source || dist[v] == INF) {
+            if (parents[v] != -1)
+                return false;
+            continue;
+        }
+        int p = parents[v];
+        if (p < 0 || p >= (int)dist.size())
+            return false;
+        bool found = false;
+        for (const auto& e : adj[p])
+            found = found ||
+                    ((size_t)e.to == v && same_distance(dist[p] + e.weight,
+                                                        dist[v]));
+        if (!found)
+            return false;
+    }
+    return true;
+}
+
+// Runs every configuration on the case. Returns an empty string when all
+// agree with Dijkstra, otherwise a description of the first mismatch.
+static string check(const Case& c) {
+    vector<vector<Edge>> adj = adjacency(c);
+    vector<double> expected = dijkstra(c.n, adj, c.source);
+
+    auto compare = [&](const vector<double>& got,
+                       const vector<double>& want) -> string {
+        for (int v = 0; v < c.n; ++v)
+            if (!same_distance(got[v], want[v]))
+                return "node " + to_string(v) + ": got " + to_string(got[v]) +
+                       ", expected " + to_string(want[v]);
+        return "";
+    };
+
+    string err = compare(solve_sssp(c.n, adj, c.source), expected);
+    if (!err.empty())
+        return "adjacency lists, " + err;
+
+    CsrGraph csr = build_csr(c.n, adj);
+    err = compare(solve_sssp(csr.view(), c.source), expected);
+    if (!err.empty())
+        return "CSR, " + err;
+
+    SsspOptions opts;
+    opts.threads = 2;
+    vector<vertex_t> parents;
+    opts.parents = &parents;
+    vector<double> dist = solve_sssp(c.n, adj, c.source, opts);
+    err = compare(dist, expected);
+    if (!err.empty())
+        return "deterministic mode, " + err;
+    if (!parents_valid(adj, c.source, dist, parents))
+        return "deterministic mode, predecessors do not form a shortest "
+               "path tree";
+
+    // Strict-improvement mode, sequential and deterministic.
+    for (int threads : {0, 2}) {
+        SsspOptions strict;
+        strict.strict = true;
+        strict.threads = threads;
+        strict.parents = &parents;
+        dist = solve_sssp(c.n, adj, c.source, strict);
+        string mode = "strict mode (" + to_string(threads) + " threads), ";
+        err = compare(dist, expected);
+        if (!err.empty())
+            return mode + err;
+        if (!parents_valid(adj, c.source, dist, parents))
+            return mode + "predecessors do not form a shortest path tree";
+    }
+
+    // Zero-weight cycles contracted, solved and expanded again.
+    ZeroContraction zc = contract_zero_cycles(c.n, adj);
+    dist = expand_distances(
+        zc.comp, solve_sssp(zc.components, zc.adj, zc.comp[c.source]));
+    err = compare(dist, expected);
+    if (!err.empty())
+        return "zero-weight contraction, " + err;
+    if (!parents_valid(adj, c.source, dist,
+                       tight_parents(adj, c.source, dist)))
+        return "zero-weight contraction, tight predecessors are invalid";
+
+    // A bound at the median finite distance cuts the ball mid-way.
+    vector<double> finite;
+    for (double d : expected)
+        if (d != INF)
+            finite.push_back(d);
+    sort(finite.begin(), finite.end());
+    double bound = finite[finite.size() / 2];
+    if (bound > 0) {
+        vector<double> ball = expected;
+        for (double& d : ball)
+            if (d >= bound)
+                d = INF;
+        err = compare(solve_sssp(c.n, adj, c.source, bound), ball);
+        if (!err.empty())
+            return "bound " + to_string(bound) + ", " + err;
+    }
+
+    // Integral weights are stored exactly by the compressed layout.
+    if (c.integral) {
+        CompressedGraph packed = compress_graph(c.n, adj, 1.0);
+        err = compare(solve_sssp(packed.view(), c.source), expected);
+        if (!err.empty())
+            return "compressed, " + err;
+    }
+    return "";
+}
+
+// Renumbers the nodes that still have edges (plus the source) densely.
+// Returns the case unchanged if the renumbered one no longer fails.
+static Case compact(const Case& c) {
+    vector<int> id(c.n, -1);
+    int next = 0;
+    id[c.source] = next++;
+    for (const auto& e : c.edges) {
+        if (id[get<0>(e)] < 0)
+            id[get<0>(e)] = next++;
+        if (id[get<1>(e)] < 0)
+            id[get<1>(e)] = next++;
+    }
+    Case small = c;
+    small.n = next;
+    small.source = 0;
+    for (auto& e : small.edges)
+        e = make_tuple(id[get<0>(e)], id[get<1>(e)], get<2>(e));
+    return check(small).empty() ? c : small;
+}
+
+// Greedy delta reduction: drop chunks of edges while the case still fails,
+// halving the chunk size down to single edges. Nodes are renumbered after
+// every pass so later checks run on a smaller graph. At most `budget`
+// candidate cases are checked.
+static Case minimize(Case c, int budget) {
+    for (size_t chunk = max<size_t>(1, c.edges.size() / 2);
+         budget > 0; chunk = max<size_t>(1, chunk / 2)) {
+        size_t before = c.edges.size();
+        for (size_t i = 0; i < c.edges.size() && budget > 0; --budget) {
+            Case trial = c;
+            size_t end = min(c.edges.size(), i + chunk);
+            trial.edges.erase(trial.edges.begin() + i,
+                              trial.edges.begin() + end);
+            if (!check(trial).empty())
+                c = trial;
+            else
+                i += chunk;
+        }
+        c = compact(c);
+        if (chunk == 1 && c.edges.size() == before)
+            break;
+    }
+    return c;
+}
+
+static void write_case(ostream& out, const Case& c) {
+    out.precision(17);
+    out << c.n << " " << c.edges.size() << "\n";
+    for (const auto& e : c.edges)
+        out << get<0>(e) << " " << get<1>(e) << " " << get<2>(e) << "\n";
+    out << c.source << "\n";
+}
+
+int main(int argc, char* argv[]) {
+    int cases = 1000;
+    unsigned long long seed = 1;
+    int max_n = 2000;
+    const char* out_path = "verify_sssp_failure.txt";
+    int minimize_budget = 20000;
+    bool verbose = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--cases") == 0 && i + 1 < argc)
+            cases = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--max-n") == 0 && i + 1 < argc)
+            max_n = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--minimize") == 0 && i + 1 < argc)
+            minimize_budget = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+            out_path = argv[++i];
+        else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0)
+            verbose = true;
+        else {
+            cerr << "Usage: " << argv[0]
+                 << " [--cases N] [--seed S] [--max-n N] [--minimize CHECKS]"
+                    " [--out FILE] [-v]"
+                 << endl;
+            return 1;
+        }
+    }
+
+    vector<int> per_family(FAMILY_COUNT, 0);
+    for (int i = 0; i < cases; ++i) {
+        // Each case has its own generator so a failure reproduces from its
+        // number alone.
+        mt19937_64 rng(seed * 1000003ULL + i);
+        int family = i % FAMILY_COUNT;
+        Case c = generate(family, max_n, rng);
+        string err = check(c);
+        per_family[family]++;
+        if (verbose)
+            cout << "case " << i << " (" << family_name(family) << ", n=" << c.n
+                 << ", m=" << c.edges.size() << "): "
+                 << (err.empty() ? "ok" : err) << endl;
+        if (err.empty())
+            continue;
+
+        cerr << "FAILED: case " << i << " (" << family_name(family)
+             << ", seed " << seed << "): " << err << endl;
+        Case small = minimize(c, minimize_budget);
+        cerr << "Minimized to n=" << small.n << ", m=" << small.edges.size()
+             << ": " << check(small) << endl;
+        ofstream out(out_path);
+        write_case(out, small);
+        if (out)
+            cerr << "Reproducer written to " << out_path << endl;
+        if (small.edges.size() <= 20)
+            write_case(cerr, small);
+        return 1;
+    }
+
+    cout << "Verified " << cases << " graphs against Dijkstra (";
+    for (int f = 0; f < FAMILY_COUNT; ++f)
+        cout << (f ? ", " : "") << per_family[f] << " " << family_name(f);
+    cout << ")" << endl;
+    return 0;
+}
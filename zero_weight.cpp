@@ -0,0 +1,128 @@
+#include "zero_weight.h"
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+using namespace std;
+
+ZeroContraction contract_zero_cycles(vertex_t n,
+                                     const vector<vector<Edge>>& adj) {
+    ZeroContraction c;
+    c.comp.assign(n, -1);
+
+    // Iterative Tarjan over the zero-weight edges. call holds the DFS path
+    // with the next edge position of each node.
+    vector<int> index(n, -1), low(n, 0);
+    vector<int> stack;
+    vector<char> on_stack(n, 0);
+    vector<pair<int, size_t>> call;
+    int counter = 0;
+    auto visit = [&](int v) {
+        index[v] = low[v] = counter++;
+        stack.push_back(v);
+        on_stack[v] = 1;
+        call.push_back({v, 0});
+    };
+
+    for (int root = 0; root < n; ++root) {
+        if (index[root] >= 0)
+            continue;
+        visit(root);
+        while (!call.empty()) {
+            int u = call.back().first;
+            size_t pos = call.back().second;
+            if (pos < adj[u].size()) {
+                call.back().second++;
+                const Edge& e = adj[u][pos];
+                if (e.weight != 0)
+                    continue;
+                if (index[e.to] < 0)
+                    visit(e.to);
+                else if (on_stack[e.to])
+                    low[u] = min(low[u], index[e.to]);
+                continue;
+            }
+            call.pop_back();
+            if (!call.empty()) {
+                int p = call.back().first;
+                low[p] = min(low[p], low[u]);
+            }
+            if (low[u] == index[u]) {
+                int v;
+                do {
+                    v = stack.back();
+                    stack.pop_back();
+                    on_stack[v] = 0;
+                    c.comp[v] = c.components;
+                } while (v != u);
+                c.components++;
+            }
+        }
+    }
+
+    // Renumber by first member so that singletons keep their ids in order.
+    vector<vertex_t> renumber(c.components, -1);
+    vertex_t next = 0;
+    for (int v = 0; v < n; ++v) {
+        if (renumber[c.comp[v]] < 0)
+            renumber[c.comp[v]] = next++;
+        c.comp[v] = renumber[c.comp[v]];
+    }
+
+    c.adj = contract_graph(adj, c.comp, c.components);
+    return c;
+}
+
+vector<vector<Edge>> contract_graph(const vector<vector<Edge>>& adj,
+                                    const vector<vertex_t>& comp,
+                                    vertex_t components) {
+    vector<vector<Edge>> out(components);
+    for (size_t u = 0; u < adj.size(); ++u)
+        for (const auto& e : adj[u])
+            if (comp[u] != comp[e.to])
+                out[comp[u]].push_back({comp[e.to], e.weight});
+
+    for (auto& row : out) {
+        sort(row.begin(), row.end(), [](const Edge& a, const Edge& b) {
+            return a.to != b.to ? a.to < b.to : a.weight < b.weight;
+        });
+        row.erase(unique(row.begin(), row.end(),
+                         [](const Edge& a, const Edge& b) {
+                             return a.to == b.to;
+                         }),
+                  row.end());
+        row.shrink_to_fit();
+    }
+    return out;
+}
+
+vector<double> expand_distances(const vector<vertex_t>& comp,
+                                const vector<double>& dist) {
+    vector<double> out(comp.size());
+    for (size_t v = 0; v < comp.size(); ++v)
+        out[v] = dist[comp[v]];
+    return out;
+}
+
+vector<vertex_t> tight_parents(const vector<vector<Edge>>& adj, vertex_t source,
+                               const vector<double>& dist) {
+    int n = (int)adj.size();
+    vector<vertex_t> parents(n, -1);
+    if (source < 0 || source >= n)
+        return parents;
+    vector<char> seen(n, 0);
+    vector<int> stack = {source};
+    seen[source] = 1;
+    while (!stack.empty()) {
+        int u = stack.back();
+        stack.pop_back();
+        for (const auto& e : adj[u]) {
+            if (seen[e.to] || dist[u] + e.weight != dist[e.to])
+                continue;
+            seen[e.to] = 1;
+            parents[e.to] = u;
+            stack.push_back(e.to);
+        }
+    }
+    return parents;
+}
@@ -0,0 +1,40 @@
+#ifndef ZERO_WEIGHT_H
+#define ZERO_WEIGHT_H
+
+#include "types.h"
+#include <vector>
+
+using namespace std;
+
+// Nodes on a common cycle of zero-weight edges are at the same distance
+// from any source, so they can be solved as a single node. The quotient
+// graph has one node per strongly connected component of the zero-weight
+// subgraph; edges inside a component are dropped and parallel edges between
+// two components keep the lowest weight.
+struct ZeroContraction {
+    vertex_t components = 0;
+    vector<vertex_t> comp;    // component of every input node
+    vector<vector<Edge>> adj; // quotient graph over the components
+};
+
+// Components are numbered by their lowest node id, so a graph without
+// zero-weight cycles maps every node to itself.
+ZeroContraction contract_zero_cycles(vertex_t n,
+                                     const vector<vector<Edge>>& adj);
+
+// Quotient of another graph over the same nodes (e.g. the transposed one).
+vector<vector<Edge>> contract_graph(const vector<vector<Edge>>& adj,
+                                    const vector<vertex_t>& comp,
+                                    vertex_t components);
+
+// Distances of the input nodes from the distances of their components.
+vector<double> expand_distances(const vector<vertex_t>& comp,
+                                const vector<double>& dist);
+
+// Predecessors from final distances: a search from the source over tight
+// edges (dist[u] + w == dist[v]), so every reached node gets a parent whose
+// edge realizes its distance and zero-weight cycles cannot form a loop.
+vector<vertex_t> tight_parents(const vector<vector<Edge>>& adj, vertex_t source,
+                               const vector<double>& dist);
+
+#endif // ZERO_WEIGHT_H